@@ -5,7 +5,7 @@ import esphome.codegen as cg
 import esphome.core as core
 import re
 import logging
-from typing import Union
+from typing import List, Tuple, Union
 import os, json
 
 from esphome.components import uart, time, esp32
@@ -18,10 +18,10 @@ from esphome.const import (
 )
 
 CODEOWNERS = ["@olicooper"]
-DEPENDENCIES = ["uart", "time", "wifi", "api", "esp32", "json"]
+DEPENDENCIES = ["uart", "time", "wifi", "api", "esp32"]
 
 def AUTO_LOAD():
-    val = ["text_sensor", "json"]
+    val = ["text_sensor"]
     return val
 
 _LOGGER = logging.getLogger(__name__)
@@ -73,12 +73,20 @@ REQUIRED_TRANSLATION_KEYS = [
     "turn_on","turn_off"
 ]
 
+# Translation keys which are looked up using a different key in the C++ code
+# (see translation_item in translations.h)
+TRANSLATION_KEY_ALIASES = {
+    "tilt_position": "tilt_pos",
+}
+
 CONF_INCOMING_MSG = "on_incoming_msg"
 CONF_ICON = "icon"
 CONF_ICON_VALUE = "value"
 CONF_ICON_COLOR = "color"
 CONF_ENTITY_ID = "entity_id"
 CONF_SLEEP_TIMEOUT = "sleep_timeout"
+CONF_COMMAND_QUEUE_SIZE = "command_queue_size"
+CONF_UART_RX_TASK = "uart_rx_task"
 
 CONF_LOCALE = "locale"
 CONF_TEMPERATURE_UNIT = "temperature_unit"
@@ -158,6 +166,56 @@ def load_translations(lang: str):
         raise cv.Invalid(f"Translation file missing the following required keys: {missingKeys}")
     _LOGGER.info(f"[nspanel_lovelace] Loaded '{lang}' translation file")
 
+FNV1A_BASIS = 2166136261
+
+# note: must match fnv1a_hash() in helpers.h
+def fnv1a_hash(value: str, basis: int = FNV1A_BASIS) -> int:
+    hash = basis
+    for b in value.encode("utf-8"):
+        hash ^= b
+        hash = (hash * 16777619) & 0xFFFFFFFF
+    return hash
+
+def build_translation_table(keys: List[str]) -> Tuple[List[str], List[int]]:
+    """Builds a minimal perfect hash of the keys (hash and displace).
+
+    Returns the keys ordered by their slot and the seed table used by
+    get_translation_slot() in translations.h to find the slot of a key.
+    """
+    size = len(keys)
+    if len(set(keys)) != size:
+        duplicates = sorted({k for k in keys if keys.count(k) > 1})
+        raise cv.Invalid(f"Translation file contains duplicate keys: {duplicates}")
+    buckets = [[] for _ in range(size)]
+    for k in keys:
+        buckets[fnv1a_hash(k) % size].append(k)
+    seeds = [0] * size
+    slots = [None] * size
+    # place the largest buckets first while most of the slots are free
+    for index in sorted(range(size), key=lambda i: len(buckets[i]), reverse=True):
+        bucket = buckets[index]
+        if len(bucket) <= 1:
+            break
+        seed = 1
+        while True:
+            placed = [fnv1a_hash(k, seed) % size for k in bucket]
+            if len(set(placed)) == len(placed) and all(slots[p] is None for p in placed):
+                break
+            seed += 1
+            if seed > 0x7FFFFFFF:
+                raise cv.Invalid("Failed to generate the translation table")
+        seeds[index] = seed
+        for k, p in zip(bucket, placed):
+            slots[p] = k
+    # keys which don't share a bucket are stored in the remaining slots directly
+    free = [i for i, k in enumerate(slots) if k is None]
+    for index, bucket in enumerate(buckets):
+        if len(bucket) == 1:
+            p = free.pop()
+            seeds[index] = -p - 1
+            slots[p] = bucket[0]
+    return slots, seeds
+
 def get_icon_hex(iconLookup: str) -> Union[str, None]:
     if not iconLookup or len(iconLookup) == 0:
         return None
@@ -378,6 +436,8 @@ CONFIG_SCHEMA = cv.All(
         cv.GenerateID(): cv.declare_id(NSPanelLovelace),
         cv.Optional(CONF_SLEEP_TIMEOUT, default=10): cv.int_range(2, 43200),
         cv.Optional(CONF_MODEL, default='eu'): cv.one_of('eu', 'us-l', 'us-p'),
+        cv.Optional(CONF_COMMAND_QUEUE_SIZE, default=4096): cv.int_range(1024, 32768),
+        cv.Optional(CONF_UART_RX_TASK, default=False): cv.boolean,
         cv.Optional(CONF_LOCALE, default={}): SCHEMA_LOCALE,
         cv.Optional(CONF_SCREENSAVER, default={}): SCHEMA_SCREENSAVER,
         cv.Optional(CONF_INCOMING_MSG): automation.validate_automation(
@@ -595,6 +655,10 @@ async def to_code(config):
                 "CONFIG_ESP_TLS_SKIP_SERVER_CERT_VERIFY", True
             )
 
+    # note: this must be set before any commands are queued
+    cg.add(nspanel.set_command_queue_size(config[CONF_COMMAND_QUEUE_SIZE]))
+    cg.add(nspanel.set_uart_rx_task(config[CONF_UART_RX_TASK]))
+
     if CONF_SLEEP_TIMEOUT in config:
         cg.add(nspanel.set_display_timeout(config[CONF_SLEEP_TIMEOUT]))
 
@@ -608,8 +672,14 @@ async def to_code(config):
     else:
         cg.add(nspanel.set_language(locale_config[CONF_LANGUAGE]))
 
+    # the keys as they are looked up in the C++ code
+    lookup_keys = [TRANSLATION_KEY_ALIASES.get(k, k) for k in translationJson.keys()]
+    slots, seeds = build_translation_table(lookup_keys)
+    json_keys = dict(zip(lookup_keys, translationJson.keys()))
     cgv = []
-    for k,v in translationJson.items():
+    for key in slots:
+        k = json_keys[key]
+        v = translationJson[k]
         if k in REQUIRED_TRANSLATION_KEYS:
             if k in cv.RESERVED_IDS:
                 k += '_'
@@ -617,8 +687,16 @@ async def to_code(config):
         cgv.append(cg.ArrayInitializer(k, v))
     cg.add_define("TRANSLATION_MAP_SIZE", len(cgv))
     cg.add_global(cg.RawStatement(
-        "constexpr FrozenCharMap<const char *, TRANSLATION_MAP_SIZE> "
+        f"constexpr esphome::{nspanel_lovelace_ns}::translation_table_t "
         f"esphome::{nspanel_lovelace_ns}::TRANSLATION_MAP {{{cg.ArrayInitializer(*cgv, multiline=True)}}};"))
+    cg.add_global(cg.RawStatement(
+        f"constexpr esphome::{nspanel_lovelace_ns}::translation_seeds_t "
+        f"esphome::{nspanel_lovelace_ns}::TRANSLATION_SEEDS {{{cg.ArrayInitializer(*seeds)}}};"))
+    # the table is only valid if the keys used by the C++ code hash the same as the keys above
+    cg.add_global(cg.RawStatement(
+        f"static_assert(esphome::{nspanel_lovelace_ns}::is_valid_translation_table("
+        f"esphome::{nspanel_lovelace_ns}::TRANSLATION_MAP, esphome::{nspanel_lovelace_ns}::TRANSLATION_SEEDS), "
+        "\"TRANSLATION_MAP does not match the translation keys, is TRANSLATION_KEY_ALIASES up to date?\");"))
 
     if CONF_TEMPERATURE_UNIT in locale_config:
         cg.add(GlobalConfig.set_temperature_unit(TEMPERATURE_UNIT_OPTION_MAP[locale_config[CONF_TEMPERATURE_UNIT]]))
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+#include <string_view>
 #include <utility>
 #include "esphome/core/component.h"
 #include "esphome/core/automation.h"
@@ -12,7 +14,7 @@ namespace nspanel_lovelace {
 class NSPanelLovelaceMsgIncomingTrigger : public Trigger<std::string> {
  public:
   explicit NSPanelLovelaceMsgIncomingTrigger(NSPanelLovelace *parent) {
-    parent->add_incoming_msg_callback([this](const std::string &value) { this->trigger(value); });
+    parent->add_incoming_msg_callback([this](std::string_view value) { this->trigger(std::string(value)); });
   }
 };
 
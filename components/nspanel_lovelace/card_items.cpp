@@ -110,7 +110,7 @@ void EntitiesCardEntityItem::state_generic_fn(StatefulPageItem *me) {
 
 void EntitiesCardEntityItem::state_on_off_fn(StatefulPageItem *me) {
   auto me_ = static_cast<EntitiesCardEntityItem*>(me);
-  me_->value_ = (me_->is_state(entity_state::on) ? "1" : "0");
+  me_->value_ = (me_->is_state(entity_state_t::on) ? "1" : "0");
   StatefulPageItem::state_on_off_fn(me);
 }
 
@@ -146,32 +146,24 @@ void EntitiesCardEntityItem::state_cover_fn(StatefulPageItem *me) {
     cover_icons,
     me_->get_attribute(ha_attr_type::device_class),
     entity_cover_type::window);
-  auto &position_str = me_->get_attribute(
+  const bool has_position = me_->get_entity()->has_attribute(
     ha_attr_type::current_position);
-  auto &supported_features_str = me_->get_attribute(
-    ha_attr_type::supported_features);
-
-  uint8_t position = 0;
-  uint8_t supported_features = 0;
+  const uint8_t position = static_cast<uint8_t>(
+    me_->get_attribute_number(ha_attr_type::current_position));
+  const uint8_t supported_features = static_cast<uint8_t>(
+    me_->get_attribute_number(ha_attr_type::supported_features));
   bool icon_up_status = false;
   bool icon_stop_status = false;
   bool icon_down_status = false;
 
   me_->value_.clear();
 
-  if (!position_str.empty()) {
-    position = std::stoi(position_str);
-  }
-  if (!supported_features_str.empty()) {
-    supported_features = std::stoi(supported_features_str);
-  }
-
   // see: https://github.com/home-assistant/core/blob/dev/homeassistant/components/cover/__init__.py#L112
   // OPEN
   if (supported_features & 0b1) {
-    if (position != 100 && !((me_->is_state(entity_state::open) ||
-        me_->is_state(entity_state::unknown)) &&
-        position_str.empty())) {
+    if (position != 100 && !((me_->is_state(entity_state_t::open) ||
+        me_->is_state(entity_state_t::unknown)) &&
+        !has_position)) {
       icon_up_status = true;
     }
     if (cover_icons_found)
@@ -180,15 +172,15 @@ void EntitiesCardEntityItem::state_cover_fn(StatefulPageItem *me) {
   me_->value_.append(1, '|');
   // STOP
   if (supported_features & 0b1000) {
-    icon_stop_status = !me_->is_state(entity_state::unknown);
+    icon_stop_status = !me_->is_state(entity_state_t::unknown);
     me_->value_.append(icon_t::stop);
   }
   me_->value_.append(1, '|');
   // CLOSE
   if (supported_features & 0b10) {
-    if (position != 0 && !((me_->is_state(entity_state::closed) ||
-        me_->is_state(entity_state::unknown)) &&
-        position_str.empty())) {
+    if (position != 0 && !((me_->is_state(entity_state_t::closed) ||
+        me_->is_state(entity_state_t::unknown)) &&
+        !has_position)) {
       icon_down_status = true;
     }
     if (cover_icons_found)
@@ -209,7 +201,7 @@ void EntitiesCardEntityItem::state_climate_fn(StatefulPageItem *me) {
 
   // backend.component.climate.state
   me_->value_.assign(get_translation(me_->get_state()));
-  if (me_->is_state(entity_state::unknown)) return;
+  if (me_->is_state(entity_state_t::unknown)) return;
   
   auto temp_unit = Configuration::get_temperature_unit_str();
   auto temp = me_->get_attribute(ha_attr_type::temperature);
@@ -236,7 +228,7 @@ void EntitiesCardEntityItem::state_number_fn(StatefulPageItem *me) {
 void EntitiesCardEntityItem::state_lock_fn(StatefulPageItem *me) {
   StatefulPageItem::state_lock_fn(me);
   auto me_ = static_cast<EntitiesCardEntityItem*>(me);
-  me_->value_ = get_translation(me_->is_state(entity_state::unlocked) ?
+  me_->value_ = get_translation(me_->is_state(entity_state_t::unlocked) ?
     translation_item::lock : translation_item::unlock);
 }
 
@@ -261,7 +253,7 @@ void EntitiesCardEntityItem::state_sun_fn(StatefulPageItem *me) {
 
 void EntitiesCardEntityItem::state_vacuum_fn(StatefulPageItem *me) {
   auto me_ = static_cast<EntitiesCardEntityItem*>(me);
-  me_->value_ = get_translation(me_->is_state(entity_state::docked) ?
+  me_->value_ = get_translation(me_->is_state(entity_state_t::docked) ?
     translation_item::start_cleaning : translation_item::return_to_base);
 }
 
@@ -272,8 +264,8 @@ void EntitiesCardEntityItem::state_translate_fn(StatefulPageItem *me) {
   const char *ret;
   std::string key = me->get_type();
   key.append(1, '.').append(me_->get_state());
-  if (!try_get_value(TRANSLATION_MAP, ret, key)) {
-    if (!try_get_value(TRANSLATION_MAP, ret, me_->get_state())) {
+  if (!try_get_translation(key, ret)) {
+    if (!try_get_translation(me_->get_state(), ret)) {
       me_->value_ = me_->get_state();
       return;
     }
@@ -281,6 +273,29 @@ void EntitiesCardEntityItem::state_translate_fn(StatefulPageItem *me) {
   me_->value_ = ret;
 }
 
+// Must match the attributes handled by on_entity_attribute_change
+uint64_t EntitiesCardEntityItem::get_attribute_mask_(const char *type) const {
+  uint64_t mask = StatefulPageItem::get_attribute_mask_(type) |
+    attribute_bit(ha_attr_type::unit_of_measurement);
+  if (type == entity_type::cover) {
+    // the only attributes state_cover_fn uses (besides device_class)
+    mask |= attribute_bit(ha_attr_type::current_position) |
+      attribute_bit(ha_attr_type::supported_features);
+  } else if (type == entity_type::climate) {
+    mask |= attribute_bit(ha_attr_type::temperature) |
+      attribute_bit(ha_attr_type::current_temperature);
+  } else if (type == entity_type::number || type == entity_type::input_number) {
+    mask |= attribute_bit(ha_attr_type::min) |
+      attribute_bit(ha_attr_type::max);
+  } else if (type == entity_type::weather) {
+    mask |= attribute_bit(ha_attr_type::temperature) |
+      attribute_bit(ha_attr_type::temperature_unit);
+  } else if (type == entity_type::media_player) {
+    mask = ALL_ATTRIBUTES;
+  }
+  return mask;
+}
+
 void EntitiesCardEntityItem::set_on_state_callback_(const char *type) {
   if (type == entity_type::light ||
       type == entity_type::switch_ ||
@@ -57,7 +57,9 @@ AlarmCard::AlarmCard(
     Card(page_type::cardAlarm, uuid),
     alarm_entity_(alarm_entity),
     show_keypad_(true), status_icon_flashing_(false) {
-  alarm_entity_->add_subscriber(this);
+  alarm_entity_->set_card_entity(true);
+  alarm_entity_->add_subscriber(this,
+    attribute_bit(ha_attr_type::code_arm_required));
   this->status_icon_ = std::unique_ptr<AlarmIconItem>(
     new AlarmIconItem(std::string(uuid).append("_s"), icon_t::shield_off, 0x0CE6)); //green
   this->info_icon_ = std::unique_ptr<AlarmIconItem>(
@@ -72,7 +74,9 @@ AlarmCard::AlarmCard(
     Card(page_type::cardAlarm, uuid, title),
     alarm_entity_(alarm_entity),
     show_keypad_(true),status_icon_flashing_(false) {
-  alarm_entity_->add_subscriber(this);
+  alarm_entity_->set_card_entity(true);
+  alarm_entity_->add_subscriber(this,
+    attribute_bit(ha_attr_type::code_arm_required));
   this->status_icon_ = std::unique_ptr<AlarmIconItem>(
     new AlarmIconItem(std::string(uuid).append("_s"), icon_t::shield_off, 0x0CE6)); //green
   this->info_icon_ = std::unique_ptr<AlarmIconItem>(
@@ -87,7 +91,9 @@ AlarmCard::AlarmCard(
     Card(page_type::cardAlarm, uuid, title, sleep_timeout),
     alarm_entity_(alarm_entity),
     show_keypad_(true),status_icon_flashing_(false) {
-  alarm_entity_->add_subscriber(this);
+  alarm_entity_->set_card_entity(true);
+  alarm_entity_->add_subscriber(this,
+    attribute_bit(ha_attr_type::code_arm_required));
   this->status_icon_ = std::unique_ptr<AlarmIconItem>(
     new AlarmIconItem(std::string(uuid).append("_s"), icon_t::shield_off, 0x0CE6)); //green
   this->info_icon_ = std::unique_ptr<AlarmIconItem>(
@@ -138,9 +144,9 @@ bool AlarmCard::add_arm_button(alarm_arm_action action) {
 void AlarmCard::on_entity_state_change(const std::string &state) {
   this->status_icon_flashing_ = false;
 
-  if (state == entity_state::triggered || 
-      state == entity_state::arming || 
-      state == entity_state::pending) {
+  if (this->alarm_entity_->is_state(entity_state_t::triggered) || 
+      this->alarm_entity_->is_state(entity_state_t::arming) || 
+      this->alarm_entity_->is_state(entity_state_t::pending)) {
     this->status_icon_flashing_ = true;
   }
 
@@ -167,8 +173,8 @@ std::string &AlarmCard::render(std::string &buffer) {
 
   buffer.append(this->alarm_entity_->get_entity_id());
 
-  if (this->alarm_entity_->is_state(entity_state::unknown) ||
-      this->alarm_entity_->is_state(entity_state::disarmed)) {
+  if (this->alarm_entity_->is_state(entity_state_t::unknown) ||
+      this->alarm_entity_->is_state(entity_state_t::disarmed)) {
     for (auto& item : this->items_) {
       buffer.append(1, SEPARATOR).append(item->render());
     }
@@ -208,7 +214,8 @@ ThermoCard::ThermoCard(const std::string &uuid,
     Card(page_type::cardThermo, uuid),
     thermo_entity_(thermo_entity) {
   this->configure_temperature_unit();
-  thermo_entity->add_subscriber(this);
+  thermo_entity->set_card_entity(true);
+  thermo_entity->add_subscriber(this, NO_ATTRIBUTES);
 }
 
 ThermoCard::ThermoCard(const std::string &uuid,
@@ -217,7 +224,8 @@ ThermoCard::ThermoCard(const std::string &uuid,
     Card(page_type::cardThermo, uuid, title),
     thermo_entity_(thermo_entity) {
   this->configure_temperature_unit();
-  thermo_entity->add_subscriber(this);
+  thermo_entity->set_card_entity(true);
+  thermo_entity->add_subscriber(this, NO_ATTRIBUTES);
 }
 
 ThermoCard::ThermoCard(
@@ -227,7 +235,8 @@ ThermoCard::ThermoCard(
     Card(page_type::cardThermo, uuid, title, sleep_timeout),
     thermo_entity_(thermo_entity) {
   this->configure_temperature_unit();
-  thermo_entity->add_subscriber(this);
+  thermo_entity->set_card_entity(true);
+  thermo_entity->add_subscriber(this, NO_ATTRIBUTES);
 }
 
 ThermoCard::~ThermoCard() {
@@ -262,22 +271,21 @@ std::string &ThermoCard::render(std::string &buffer) {
   buffer.append(Configuration::get_temperature_unit_str());
   buffer.append(1, SEPARATOR);
 
-  std::string dest_temp_str = 
-    this->thermo_entity_->get_attribute(ha_attr_type::temperature);
+  auto entity = this->thermo_entity_.get();
+  std::string dest_temp_str;
   std::string dest_temp2_str;
 
-  if (dest_temp_str.empty()) {
-    dest_temp_str = this->thermo_entity_->get_attribute(
-      ha_attr_type::target_temp_high, "0");
-    dest_temp2_str = this->thermo_entity_->get_attribute(
-      ha_attr_type::target_temp_low);
-    if (!dest_temp2_str.empty()) {
-      dest_temp2_str = std::to_string(
-        static_cast<int>(std::stof(dest_temp2_str) * 10));
+  if (entity->has_attribute(ha_attr_type::temperature)) {
+    dest_temp_str = std::to_string(static_cast<int>(
+      entity->get_attribute_number(ha_attr_type::temperature) * 10));
+  } else {
+    dest_temp_str = std::to_string(static_cast<int>(
+      entity->get_attribute_number(ha_attr_type::target_temp_high) * 10));
+    if (entity->has_attribute(ha_attr_type::target_temp_low)) {
+      dest_temp2_str = std::to_string(static_cast<int>(
+        entity->get_attribute_number(ha_attr_type::target_temp_low) * 10));
     }
   }
-  dest_temp_str = std::to_string(
-    static_cast<int>(std::stof(dest_temp_str) * 10));
 
   buffer.append(dest_temp_str).append(1, SEPARATOR);
 
@@ -297,30 +305,23 @@ std::string &ThermoCard::render(std::string &buffer) {
   buffer.append(1, SEPARATOR);
 
   buffer.append(std::to_string(static_cast<int>(
-    std::stof(this->thermo_entity_->get_attribute(
-      ha_attr_type::min_temp, "0")) * 10)));
+    entity->get_attribute_number(ha_attr_type::min_temp) * 10)));
   buffer.append(1, SEPARATOR);
 
   buffer.append(std::to_string(static_cast<int>(
-    std::stof(this->thermo_entity_->get_attribute(
-      ha_attr_type::max_temp, "0")) * 10)));
+    entity->get_attribute_number(ha_attr_type::max_temp) * 10)));
   buffer.append(1, SEPARATOR);
 
   buffer.append(std::to_string(static_cast<int>(
-    std::stof(this->thermo_entity_->get_attribute(
-      ha_attr_type::target_temp_step, "0.5")) * 10)));
+    entity->get_attribute_number(ha_attr_type::target_temp_step, 0.5f) * 10)));
   
   //TODO: add overwrite_supported_modes
-  auto& hvac_modes_str = 
-    this->thermo_entity_->get_attribute(ha_attr_type::hvac_modes);
-  if (hvac_modes_str.empty()) {
+  auto hvac_modes =
+    this->thermo_entity_->get_attribute_list(ha_attr_type::hvac_modes);
+  if (hvac_modes.empty()) {
     buffer.append(4 * 8, SEPARATOR);
   } else {
-    std::vector<std::string> hvac_modes;
-    hvac_modes.reserve(6);
-    split_str(',', hvac_modes_str, hvac_modes);
-
-    for (auto& mode : hvac_modes) {
+    for (auto mode : hvac_modes) {
       uint16_t active_colour = 64512U; //dark orange
       if (mode == entity_state::auto_ ||
           mode == entity_state::heat_cool) {
@@ -373,7 +374,8 @@ MediaCard::MediaCard(const std::string &uuid,
     const std::shared_ptr<Entity> &media_entity) :
     Card(page_type::cardMedia, uuid),
     media_entity_(media_entity) {
-  media_entity->add_subscriber(this);
+  media_entity->set_card_entity(true);
+  media_entity->add_subscriber(this, NO_ATTRIBUTES);
 }
 
 MediaCard::MediaCard(const std::string &uuid,
@@ -381,7 +383,8 @@ MediaCard::MediaCard(const std::string &uuid,
     const std::string &title) :
     Card(page_type::cardMedia, uuid, title),
     media_entity_(media_entity) {
-  media_entity->add_subscriber(this);
+  media_entity->set_card_entity(true);
+  media_entity->add_subscriber(this, NO_ATTRIBUTES);
 }
 
 MediaCard::MediaCard(const std::string &uuid,
@@ -389,7 +392,8 @@ MediaCard::MediaCard(const std::string &uuid,
     const std::string &title, const uint16_t sleep_timeout) :
     Card(page_type::cardMedia, uuid, title, sleep_timeout),
     media_entity_(media_entity) {
-  media_entity->add_subscriber(this);
+  media_entity->set_card_entity(true);
+  media_entity->add_subscriber(this, NO_ATTRIBUTES);
 }
 
 MediaCard::~MediaCard() {
@@ -418,21 +422,20 @@ std::string &MediaCard::render(std::string &buffer) {
     ha_attr_type::media_artist).substr(0, 40));
   buffer.append(2, SEPARATOR);
 
-  buffer.append(std::to_string(
-    static_cast<uint8_t>(std::stof(this->media_entity_->get_attribute(
-      ha_attr_type::volume_level, "0")) * 100.0f)));
+  buffer.append(std::to_string(static_cast<uint8_t>(
+    this->media_entity_->get_attribute_number(ha_attr_type::volume_level) * 100.0f)));
   buffer.append(1, SEPARATOR);
 
-  auto icon = this->media_entity_->is_state(entity_state::playing)
+  auto icon = this->media_entity_->is_state(entity_state_t::playing)
     ? icon_t::pause : icon_t::play;
   buffer.append(icon).append(1, SEPARATOR);
 
-  uint32_t supported_features = value_or_default(this->media_entity_->
-    get_attribute(ha_attr_type::supported_features), 0UL);
+  uint32_t supported_features = static_cast<uint32_t>(
+    this->media_entity_->get_attribute_number(ha_attr_type::supported_features));
 
   // on/off button colour
   if (supported_features & 0b10000000) {
-    if (this->media_entity_->is_state(entity_state::off))
+    if (this->media_entity_->is_state(entity_state_t::off))
       buffer.append(std::to_string(1374)); // light blue
     else
       buffer.append(std::to_string(64704)); // orange
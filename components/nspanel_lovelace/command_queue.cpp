@@ -0,0 +1,370 @@
+#include "command_queue.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include "config.h"
+#include "helpers.h"
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+static const char *const TAG = "nspanel_lovelace";
+
+static command_kind to_command_kind(std::string_view name) {
+  command_kind kind;
+  switch (fnv1a_hash(name)) {
+  case fnv1a_hash("pageType"): kind = command_kind::pageType; break;
+  case fnv1a_hash("entityUpd"): kind = command_kind::entityUpd; break;
+  case fnv1a_hash("entityUpdateDetail"): kind = command_kind::entityUpdateDetail; break;
+  case fnv1a_hash("entityUpdateDetail2"): kind = command_kind::entityUpdateDetail2; break;
+  case fnv1a_hash("time"): kind = command_kind::time; break;
+  case fnv1a_hash("date"): kind = command_kind::date; break;
+  case fnv1a_hash("statusUpdate"): kind = command_kind::statusUpdate; break;
+  case fnv1a_hash("weatherUpdate"): kind = command_kind::weatherUpdate; break;
+  default: return command_kind::other;
+  }
+  return name == to_string(kind) ? kind : command_kind::other;
+}
+
+command_key get_command_key(std::string_view command) {
+  command_key key{command_kind::other, 0};
+  auto pos = command.find(SEPARATOR);
+  key.kind = to_command_kind(command.substr(0, pos));
+  // detail updates are specific to the popup item (the 2nd field)
+  if (pos != std::string_view::npos && (
+      key.kind == command_kind::entityUpdateDetail ||
+      key.kind == command_kind::entityUpdateDetail2)) {
+    auto target = command.substr(pos + 1);
+    key.target = fnv1a_hash(target.substr(0, target.find(SEPARATOR)));
+  }
+  return key;
+}
+
+void CommandQueue::set_capacity(size_t capacity) {
+  if (capacity == this->capacity_) return;
+  this->capacity_ = capacity;
+  this->clear();
+  this->allocate_();
+}
+
+void CommandQueue::allocate_() {
+  if (this->capacity_ == 0)
+    this->capacity_ = DEFAULT_COMMAND_QUEUE_SIZE;
+  // note: the arena is allocated once and never resized
+  this->data_.resize(this->capacity_);
+  this->data_.shrink_to_fit();
+}
+
+bool CommandQueue::push(const std::string &command, const command_key &key) {
+  if (this->data_.empty()) this->allocate_();
+
+  if (is_coalescable(key.kind) && this->try_replace_(key, command))
+    return true;
+
+  const size_t len = HEADER_SIZE + command.size();
+  if (command.size() > UINT16_MAX || len > this->capacity_) {
+    ESP_LOGW(TAG, "Command too large for queue (%zu bytes)", command.size());
+    this->dropped_count_++;
+    return false;
+  }
+
+  // drop the oldest commands until there is enough space
+  while (!this->reserve_(len)) {
+    ESP_LOGW(TAG, "Command queue full, dropping oldest command");
+    this->pop();
+    this->dropped_count_++;
+  }
+
+  this->append_(key, command);
+  return true;
+}
+
+bool CommandQueue::try_replace_(const command_key &key, const std::string &command) {
+  size_t offset = this->head_;
+  size_t match = SIZE_MAX;
+  for (size_t i = 0; i < this->entries_; i++) {
+    auto header = this->read_header_(offset);
+    if (header.kind == command_kind::pageType) {
+      // the display state changes here so earlier commands must stay as they are
+      match = SIZE_MAX;
+    } else if (!header.removed && header.kind == key.kind && header.target == key.target) {
+      match = offset;
+    }
+    offset = this->next_offset_(offset, header);
+  }
+  if (match == SIZE_MAX) return false;
+
+  this->coalesced_count_++;
+  auto header = this->read_header_(match);
+  if (command.size() <= header.slot) {
+    ESP_LOGVV(TAG, "Command replaced in queue: %s", to_string(key.kind));
+    header.length = static_cast<uint16_t>(command.size());
+    // the new command has only been waiting from now
+    header.queued_at = millis();
+    this->write_header_(match, header);
+    std::memcpy(&this->data_[match + HEADER_SIZE], command.data(), command.size());
+    return true;
+  }
+
+  // the new command does not fit, remove the old one and queue the new one instead
+  ESP_LOGVV(TAG, "Command superseded in queue: %s", to_string(key.kind));
+  header.removed = true;
+  this->write_header_(match, header);
+  this->count_--;
+  this->skip_removed_();
+  return false;
+}
+
+void CommandQueue::append_(const command_key &key, const std::string &command) {
+  entry_header header{};
+  header.length = static_cast<uint16_t>(command.size());
+  header.slot = header.length;
+  header.kind = key.kind;
+  header.removed = false;
+  header.target = key.target;
+  header.queued_at = millis();
+  this->write_header_(this->tail_, header);
+  std::memcpy(&this->data_[this->tail_ + HEADER_SIZE], command.data(), command.size());
+
+  const size_t len = HEADER_SIZE + command.size();
+  this->tail_ += len;
+  this->entries_++;
+  this->count_++;
+  this->used_ += len;
+  this->high_water_mark_ = std::max(this->high_water_mark_, this->used_);
+}
+
+bool CommandQueue::reserve_(size_t len) {
+  if (this->entries_ == 0) this->clear();
+
+  if (!this->wrapped_) {
+    if (this->capacity_ - this->tail_ >= len) return true;
+    // not enough room at the end, continue from the start of the arena
+    if (this->head_ >= len) {
+      this->wrap_ = this->tail_;
+      this->tail_ = 0;
+      this->wrapped_ = true;
+      return true;
+    }
+    return false;
+  }
+  return this->head_ - this->tail_ >= len;
+}
+
+CommandQueue::entry_header CommandQueue::read_header_(size_t offset) const {
+  entry_header header;
+  std::memcpy(&header, &this->data_[offset], HEADER_SIZE);
+  return header;
+}
+
+void CommandQueue::write_header_(size_t offset, const entry_header &header) {
+  std::memcpy(&this->data_[offset], &header, HEADER_SIZE);
+}
+
+size_t CommandQueue::next_offset_(size_t offset, const entry_header &header) const {
+  offset += HEADER_SIZE + header.slot;
+  if (this->wrapped_ && offset == this->wrap_) return 0;
+  return offset;
+}
+
+std::string_view CommandQueue::front() const {
+  if (this->count_ == 0) return {};
+  auto header = this->read_header_(this->head_);
+  return std::string_view(
+    reinterpret_cast<const char *>(&this->data_[this->head_ + HEADER_SIZE]),
+    header.length);
+}
+
+command_kind CommandQueue::front_kind() const {
+  if (this->count_ == 0) return command_kind::other;
+  return this->read_header_(this->head_).kind;
+}
+
+uint32_t CommandQueue::front_queued_at() const {
+  if (this->count_ == 0) return 0;
+  return this->read_header_(this->head_).queued_at;
+}
+
+template<typename Predicate>
+void CommandQueue::remove_if_(Predicate predicate) {
+  size_t offset = this->head_;
+  for (size_t i = 0; i < this->entries_; i++) {
+    auto header = this->read_header_(offset);
+    if (!header.removed && predicate(header)) {
+      header.removed = true;
+      this->write_header_(offset, header);
+      this->count_--;
+    }
+    offset = this->next_offset_(offset, header);
+  }
+  this->skip_removed_();
+}
+
+void CommandQueue::remove(const command_key &key) {
+  this->remove_if_([&key](const entry_header &header) {
+    return header.kind == key.kind && header.target == key.target;
+  });
+}
+
+void CommandQueue::remove(command_kind kind) {
+  this->remove_if_([kind](const entry_header &header) {
+    return header.kind == kind;
+  });
+}
+
+void CommandQueue::pop() {
+  if (this->count_ == 0) return;
+  this->pop_entry_();
+  this->skip_removed_();
+}
+
+void CommandQueue::pop_entry_() {
+  auto header = this->read_header_(this->head_);
+  const size_t len = HEADER_SIZE + header.slot;
+  this->head_ = this->next_offset_(this->head_, header);
+  if (this->head_ == 0) this->wrapped_ = false;
+  this->used_ -= len;
+  this->entries_--;
+  if (!header.removed) this->count_--;
+  if (this->entries_ == 0) this->clear();
+}
+
+// the entry at the read position must always be a command waiting to be sent
+void CommandQueue::skip_removed_() {
+  while (this->entries_ > 0 && this->read_header_(this->head_).removed) {
+    this->pop_entry_();
+  }
+}
+
+void CommandQueue::clear() {
+  this->head_ = 0;
+  this->tail_ = 0;
+  this->wrap_ = 0;
+  this->wrapped_ = false;
+  this->entries_ = 0;
+  this->count_ = 0;
+  this->used_ = 0;
+}
+
+bool SentCommandCache::is_duplicate(const command_key &key, std::string_view command) {
+  if (!is_coalescable(key.kind)) return false;
+  for (uint8_t i = 0; i < this->count_; i++) {
+    const auto &e = this->entries_[i];
+    if (e.key.kind != key.kind || e.key.target != key.target) continue;
+    if (e.length != command.size() || e.hash != fnv1a_hash(command)) return false;
+    this->suppressed_count_++;
+    this->suppressed_bytes_ += command.size();
+    return true;
+  }
+  return false;
+}
+
+void SentCommandCache::update(const command_key &key, std::string_view command) {
+  if (key.kind == command_kind::pageType) {
+    // the new page is rendered from scratch
+    this->clear();
+    return;
+  }
+  if (!is_coalescable(key.kind)) return;
+
+  entry *e = nullptr;
+  for (uint8_t i = 0; i < this->count_; i++) {
+    if (this->entries_[i].key.kind == key.kind && this->entries_[i].key.target == key.target) {
+      e = &this->entries_[i];
+      break;
+    }
+  }
+  if (e == nullptr) {
+    if (this->count_ < SIZE) {
+      e = &this->entries_[this->count_++];
+    } else {
+      e = &this->entries_[this->next_];
+      this->next_ = (this->next_ + 1) % SIZE;
+    }
+  }
+  e->key = key;
+  e->length = static_cast<uint16_t>(command.size());
+  e->hash = fnv1a_hash(command);
+}
+
+void SentCommandCache::clear() {
+  this->count_ = 0;
+  this->next_ = 0;
+}
+
+void CommandScheduler::set_capacity(size_t capacity) {
+  const size_t interactive = capacity / 2;
+  this->queue_(command_lane::interactive).set_capacity(interactive);
+  this->queue_(command_lane::background).set_capacity(capacity - interactive);
+}
+
+size_t CommandScheduler::get_capacity() const {
+  return this->get_queue(command_lane::interactive).get_capacity() +
+    this->get_queue(command_lane::background).get_capacity();
+}
+
+bool CommandScheduler::empty() const {
+  return this->queues_[0].empty() && this->queues_[1].empty();
+}
+
+size_t CommandScheduler::size() const {
+  return this->queues_[0].size() + this->queues_[1].size();
+}
+
+bool CommandScheduler::push(const std::string &command, bool interactive) {
+  auto key = get_command_key(command);
+  if (key.kind == command_kind::pageType ||
+      key.kind == command_kind::entityUpdateDetail ||
+      key.kind == command_kind::entityUpdateDetail2) {
+    interactive = true;
+  }
+  auto &queue = this->queue_(interactive ? command_lane::interactive : command_lane::background);
+  auto &other = this->queue_(interactive ? command_lane::background : command_lane::interactive);
+
+  if (key.kind == command_kind::pageType) {
+    // The page content still waiting in the background lane would be sent after
+    // the page has changed, the new page renders its own content anyway.
+    other.remove(command_kind::entityUpd);
+    other.remove(command_kind::statusUpdate);
+    other.remove(command_kind::weatherUpdate);
+  } else if (is_coalescable(key.kind)) {
+    // An older command in the other lane could be sent after this one
+    other.remove(key);
+  }
+  return queue.push(command, key);
+}
+
+command_lane CommandScheduler::next_lane_() const {
+  if (this->get_queue(command_lane::interactive).empty())
+    return command_lane::background;
+  if (this->get_queue(command_lane::background).empty())
+    return command_lane::interactive;
+  return this->interactive_streak_ >= BACKGROUND_STARVATION_LIMIT
+    ? command_lane::background : command_lane::interactive;
+}
+
+void CommandScheduler::pop() {
+  const auto lane = this->next_lane_();
+  auto &queue = this->queue_(lane);
+  if (queue.empty()) return;
+
+  auto &stats = this->stats_[(uint8_t)lane];
+  const uint32_t delay = millis() - queue.front_queued_at();
+  stats.sent++;
+  stats.total_delay_ms += delay;
+  if (delay > stats.max_delay_ms) stats.max_delay_ms = delay;
+  queue.pop();
+
+  if (lane == command_lane::interactive && !this->get_queue(command_lane::background).empty()) {
+    this->interactive_streak_++;
+  } else {
+    this->interactive_streak_ = 0;
+  }
+}
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
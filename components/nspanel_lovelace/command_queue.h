@@ -0,0 +1,241 @@
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+enum class command_kind : uint8_t {
+  other,
+  pageType,
+  entityUpd,
+  entityUpdateDetail,
+  entityUpdateDetail2,
+  time,
+  date,
+  statusUpdate,
+  weatherUpdate,
+};
+
+static constexpr const char* command_kind_names [] = {
+  "other",
+  "pageType",
+  "entityUpd",
+  "entityUpdateDetail",
+  "entityUpdateDetail2",
+  "time",
+  "date",
+  "statusUpdate",
+  "weatherUpdate",
+};
+
+inline const char *to_string(command_kind kind) {
+  if ((size_t)kind >= (sizeof(command_kind_names) / sizeof(*command_kind_names)))
+    return nullptr;
+  return command_kind_names[(uint8_t)kind];
+}
+
+// Identifies the command by its name (and target for detail updates)
+struct command_key {
+  command_kind kind;
+  // hash of the target uuid (entityUpdateDetail only)
+  uint32_t target;
+};
+
+command_key get_command_key(std::string_view command);
+
+// Only the latest command of these kinds needs to be sent,
+// queued commands are replaced when a newer one is queued
+inline bool is_coalescable(command_kind kind) {
+  return kind != command_kind::other && kind != command_kind::pageType;
+}
+
+/**
+ * FIFO of display commands stored in a single preallocated byte arena.
+ *
+ * Each command is stored contiguously as a header followed by the payload.
+ * When there is no room at the end of the arena the next command starts
+ * from the beginning again (the remaining bytes are left unused until the
+ * read position wraps). When the arena is full the oldest commands are
+ * dropped to make room for the new one.
+ *
+ * A command which supersedes a queued command of the same kind (and target)
+ * replaces it, in place when it fits. Commands are never moved across a
+ * queued 'pageType' command since the display state changes at that point.
+ */
+class CommandQueue {
+public:
+  // Must be called before the queue is used, otherwise the
+  // default size will be allocated when the first command is queued
+  void set_capacity(size_t capacity);
+  size_t get_capacity() const { return this->capacity_; }
+
+  bool push(const std::string &command) { return this->push(command, get_command_key(command)); }
+  bool push(const std::string &command, const command_key &key);
+
+  bool empty() const { return this->count_ == 0; }
+  size_t size() const { return this->count_; }
+  // Only valid until the next call to push() or pop()
+  std::string_view front() const;
+  command_kind front_kind() const;
+  // millis() when the command at the front was queued (or last replaced)
+  uint32_t front_queued_at() const;
+  void pop();
+  void clear();
+
+  // Removes all queued commands with the same key
+  void remove(const command_key &key);
+  // Removes all queued commands of the kind (regardless of target)
+  void remove(command_kind kind);
+
+  // Bytes currently used by queued commands (including headers)
+  size_t get_used() const { return this->used_; }
+  size_t get_high_water_mark() const { return this->high_water_mark_; }
+  uint32_t get_dropped_count() const { return this->dropped_count_; }
+  uint32_t get_coalesced_count() const { return this->coalesced_count_; }
+
+protected:
+  struct entry_header {
+    // length of the command
+    uint16_t length;
+    // space reserved for the command, can be larger than the
+    // length when the command was replaced with a shorter one
+    uint16_t slot;
+    command_kind kind;
+    // the entry was superseded by a newer one and must be skipped
+    bool removed;
+    uint32_t target;
+    uint32_t queued_at;
+  };
+  static constexpr size_t HEADER_SIZE = sizeof(entry_header);
+
+  void allocate_();
+  // Makes sure 'len' contiguous bytes are available at the write position
+  bool reserve_(size_t len);
+  bool try_replace_(const command_key &key, const std::string &command);
+  void append_(const command_key &key, const std::string &command);
+  void pop_entry_();
+  void skip_removed_();
+  template<typename Predicate> void remove_if_(Predicate predicate);
+  entry_header read_header_(size_t offset) const;
+  void write_header_(size_t offset, const entry_header &header);
+  size_t next_offset_(size_t offset, const entry_header &header) const;
+
+  std::vector<uint8_t> data_;
+  size_t capacity_ = 0;
+  size_t head_ = 0;
+  size_t tail_ = 0;
+  // the end of the commands at the top of the arena when writing has wrapped
+  size_t wrap_ = 0;
+  bool wrapped_ = false;
+  // number of entries in the arena (including removed entries)
+  size_t entries_ = 0;
+  // number of commands waiting to be sent
+  size_t count_ = 0;
+  size_t used_ = 0;
+  size_t high_water_mark_ = 0;
+  uint32_t dropped_count_ = 0;
+  uint32_t coalesced_count_ = 0;
+};
+
+/**
+ * Remembers the hash of the last command of each kind (and target) sent to the
+ * display so a command which would not change what is shown can be skipped.
+ *
+ * The cache must be cleared whenever the display state is unknown (i.e. when
+ * the display restarts or the user interacts with it). Sending a 'pageType'
+ * command clears it too.
+ */
+class SentCommandCache {
+public:
+  static constexpr size_t SIZE = 8u;
+
+  // Returns true when the command matches the last one of its kind sent
+  bool is_duplicate(const command_key &key, std::string_view command);
+  // Must be called for every command sent
+  void update(const command_key &key, std::string_view command);
+  void clear();
+
+  uint32_t get_suppressed_count() const { return this->suppressed_count_; }
+  uint32_t get_suppressed_bytes() const { return this->suppressed_bytes_; }
+
+protected:
+  struct entry {
+    command_key key;
+    uint16_t length;
+    uint32_t hash;
+  };
+
+  std::array<entry, SIZE> entries_;
+  uint8_t count_ = 0;
+  // the entry to replace next when the cache is full
+  uint8_t next_ = 0;
+  uint32_t suppressed_count_ = 0;
+  uint32_t suppressed_bytes_ = 0;
+};
+
+enum class command_lane : uint8_t { interactive, background };
+
+static constexpr const char* command_lane_names [] = {
+  "interactive",
+  "background",
+};
+
+inline const char *to_string(command_lane lane) {
+  if ((size_t)lane >= (sizeof(command_lane_names) / sizeof(*command_lane_names)))
+    return nullptr;
+  return command_lane_names[(uint8_t)lane];
+}
+
+struct command_lane_stats {
+  uint32_t sent = 0;
+  uint32_t total_delay_ms = 0;
+  uint32_t max_delay_ms = 0;
+};
+
+/**
+ * Schedules display commands over two queues (lanes).
+ *
+ * Interactive commands (page changes, popups and responses to button presses)
+ * are always sent before background commands (HA updates, time etc.), but a
+ * background command is sent after BACKGROUND_STARVATION_LIMIT interactive
+ * commands in a row so background commands are never starved.
+ * The capacity is split evenly between the lanes.
+ */
+class CommandScheduler {
+public:
+  static constexpr uint8_t BACKGROUND_STARVATION_LIMIT = 4u;
+
+  void set_capacity(size_t capacity);
+  size_t get_capacity() const;
+
+  bool push(const std::string &command, bool interactive);
+
+  bool empty() const;
+  size_t size() const;
+  // The next command to send, only valid until the next call to push() or pop()
+  std::string_view front() const { return this->next_queue_().front(); }
+  command_kind front_kind() const { return this->next_queue_().front_kind(); }
+  void pop();
+
+  const CommandQueue &get_queue(command_lane lane) const { return this->queues_[(uint8_t)lane]; }
+  const command_lane_stats &get_stats(command_lane lane) const { return this->stats_[(uint8_t)lane]; }
+
+protected:
+  command_lane next_lane_() const;
+  const CommandQueue &next_queue_() const { return this->get_queue(this->next_lane_()); }
+  CommandQueue &queue_(command_lane lane) { return this->queues_[(uint8_t)lane]; }
+
+  std::array<CommandQueue, 2> queues_;
+  std::array<command_lane_stats, 2> stats_;
+  // number of interactive commands sent in a row while background commands were waiting
+  uint8_t interactive_streak_ = 0;
+};
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string>
 #include <memory>
@@ -15,7 +16,26 @@ enum class nspanel_model_t : uint8_t { unknown, eu, us_l, us_p };
 constexpr char SEPARATOR = '~';
 // workaround for https://github.com/sairon/esphome-nspanel-lovelace-ui/issues/8
 constexpr uint8_t COMMAND_COOLDOWN = 75u;
+// Size of the buffer used to receive data from the display (must be a power of 2)
+constexpr size_t UART_RX_BUFFER_SIZE = 512u;
+// Initial size of the buffer used to assemble frames sent to the display
+constexpr size_t UART_TX_BUFFER_SIZE = 512u;
+// Default size of the buffer used to queue commands for the display (bytes)
+constexpr size_t DEFAULT_COMMAND_QUEUE_SIZE = 4096u;
 constexpr uint16_t DEFAULT_SLEEP_TIMEOUT_S = 20u;
+// Number of weather forecast items the screensaver can show
+constexpr size_t WEATHER_FORECAST_MAX_ITEMS = 4u;
+// Number of jobs which can be waiting for (or completed by) the worker task
+constexpr size_t WORKER_QUEUE_SIZE = 16u;
+constexpr uint32_t WORKER_TASK_STACK_SIZE = 4096u;
+constexpr uint8_t WORKER_TASK_PRIORITY = 1u;
+// Number of messages the UART receive task can queue for loop() (must be a power of 2)
+constexpr size_t UART_RX_TASK_QUEUE_SIZE = 8u;
+constexpr uint32_t UART_RX_TASK_STACK_SIZE = 3072u;
+// Higher than the loop task so frames are read as soon as they arrive
+constexpr uint8_t UART_RX_TASK_PRIORITY = 5u;
+// Longest time the UART receive task waits for an event before checking if it should stop (ms)
+constexpr uint32_t UART_RX_TASK_TIMEOUT_MS = 100u;
 // Change this value when the state object structure changes
 constexpr uint32_t RESTORE_STATE_VERSION = 0xA62E0210;
 
@@ -0,0 +1,54 @@
+#include "crc16.h"
+
+#include <array>
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+static constexpr uint16_t CRC16_POLY = 0xA001;
+static constexpr size_t CRC16_SLICES = 4;
+
+using crc16_table_t = std::array<std::array<uint16_t, 256>, CRC16_SLICES>;
+
+static constexpr crc16_table_t make_crc16_table() {
+  crc16_table_t table{};
+  for (uint16_t i = 0; i < 256; i++) {
+    uint16_t crc = i;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ CRC16_POLY : (crc >> 1);
+    }
+    table[0][i] = crc;
+  }
+  // table[n] is the crc of a byte followed by n zero bytes
+  for (size_t n = 1; n < CRC16_SLICES; n++) {
+    for (uint16_t i = 0; i < 256; i++) {
+      uint16_t prev = table[n - 1][i];
+      table[n][i] = (prev >> 8) ^ table[0][prev & 0xFF];
+    }
+  }
+  return table;
+}
+
+static constexpr crc16_table_t CRC16_TABLE = make_crc16_table();
+
+void Crc16::update(uint8_t byte) {
+  this->crc_ = (this->crc_ >> 8) ^ CRC16_TABLE[0][(this->crc_ ^ byte) & 0xFF];
+}
+
+void Crc16::update(const uint8_t *data, size_t len) {
+  uint16_t crc = this->crc_;
+  while (len >= CRC16_SLICES) {
+    crc ^= static_cast<uint16_t>(data[0]) | (static_cast<uint16_t>(data[1]) << 8);
+    crc = CRC16_TABLE[3][crc & 0xFF] ^ CRC16_TABLE[2][crc >> 8] ^
+          CRC16_TABLE[1][data[2]] ^ CRC16_TABLE[0][data[3]];
+    data += CRC16_SLICES;
+    len -= CRC16_SLICES;
+  }
+  while (len--) {
+    crc = (crc >> 8) ^ CRC16_TABLE[0][(crc ^ *data++) & 0xFF];
+  }
+  this->crc_ = crc;
+}
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+/**
+ * Table driven CRC-16/MODBUS (reflected poly 0xA001, init 0xFFFF) as used by
+ * the TFT protocol framing. Produces the same result as esphome::crc16().
+ *
+ * Data can be fed incrementally, 4 bytes are processed per step
+ * using the slice-by-4 lookup tables.
+ */
+class Crc16 {
+public:
+  static constexpr uint16_t INITIAL_VALUE = 0xFFFF;
+
+  void reset() { this->crc_ = INITIAL_VALUE; }
+  uint16_t value() const { return this->crc_; }
+
+  void update(uint8_t byte);
+  void update(const uint8_t *data, size_t len);
+  void update(const std::string &data) {
+    this->update(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+  }
+
+  static uint16_t calculate(const uint8_t *data, size_t len) {
+    Crc16 crc;
+    crc.update(data, len);
+    return crc.value();
+  }
+
+protected:
+  uint16_t crc_ = INITIAL_VALUE;
+};
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
@@ -3,30 +3,32 @@
 namespace esphome {
 namespace nspanel_lovelace {
 
-Entity::Entity(const std::string &entity_id) :
-    state_(entity_state::unknown) {
+Entity::Entity(const std::string &entity_id) {
   assert(!entity_id.empty());
   this->set_entity_id(entity_id);
   enable_notifications_ = true;
 }
 Entity::Entity(const std::string &entity_id, const char *type) : 
-    type_(type), type_overridden_(true),
-    state_(entity_state::unknown) {
+    type_(type), type_overridden_(true) {
   assert(!entity_id.empty() && type != nullptr);
   this->set_entity_id(entity_id);
   enable_notifications_ = true;
 }
 
-void Entity::add_subscriber(IEntitySubscriber *const target) {
+uint32_t Entity::dispatched_attribute_notifications_ = 0;
+uint32_t Entity::skipped_attribute_notifications_ = 0;
+uint32_t Entity::duplicate_attribute_updates_ = 0;
+
+void Entity::add_subscriber(IEntitySubscriber *const target, uint64_t attribute_mask) {
   // for (auto t : this->targets_) {
   //     if (t == target) return;
   // }
-  this->targets_.push_back(target);
+  this->targets_.push_back({target, attribute_mask});
 }
 
 bool Entity::remove_subscriber(const IEntitySubscriber *const target) {
   for (auto iter = this->targets_.begin(); iter != this->targets_.end(); ++iter) {
-    if (*iter == target) {
+    if (iter->target == target) {
       this->targets_.erase(iter);
       return true;
     }
@@ -37,6 +39,17 @@ bool Entity::remove_subscriber(const IEntitySubscriber *const target) {
   return false;
 }
 
+bool Entity::set_subscriber_attribute_mask(
+    const IEntitySubscriber *const target, uint64_t attribute_mask) {
+  for (auto &subscription : this->targets_) {
+    if (subscription.target == target) {
+      subscription.attribute_mask = attribute_mask;
+      return true;
+    }
+  }
+  return false;
+}
+
 const std::string &Entity::get_entity_id() const { return this->entity_id_; }
 
 void Entity::set_entity_id(const std::string &entity_id) {
@@ -82,94 +95,323 @@ bool Entity::set_type(const char *type) {
   return true;
 }
 
-bool Entity::is_state(const std::string &state) const { return this->state_ == state; }
+// The strings for the interned states, so get_state() can return a reference
+static const std::string &get_entity_state_str(entity_state_t state) {
+  static const auto strings = []() {
+    std::array<std::string, sizeof(entity_state_names) / sizeof(*entity_state_names)> ret;
+    for (size_t i = 0; i < ret.size(); i++) ret[i] = entity_state_names[i];
+    return ret;
+  }();
+  return strings[static_cast<uint8_t>(state)];
+}
 
-const std::string &Entity::get_state() const { return this->state_; }
+bool Entity::is_state(std::string_view state) const { return this->get_state() == state; }
+
+const std::string &Entity::get_state() const {
+  if (this->state_id_ == entity_state_t::other) return this->state_;
+  return get_entity_state_str(this->state_id_);
+}
 
-void Entity::set_state(const std::string &state) {
-  if (this->state_ == state) return;
-  this->state_ = state;
+bool Entity::set_state(std::string state) {
+  auto state_id = to_entity_state(state);
+  if (state_id == entity_state_t::other) {
+    if (this->state_id_ == entity_state_t::other && this->state_ == state) return false;
+    this->state_ = std::move(state);
+  } else {
+    if (this->state_id_ == state_id) return false;
+    if (!this->state_.empty()) {
+      // free the previous free text state
+      std::string().swap(this->state_);
+    }
+  }
+  this->state_id_ = state_id;
 
   if (this->enable_notifications_) {
-    this->notify_state_change(state);
+    this->notify_state_change(this->get_state());
   }
+  return true;
+}
+
+static constexpr uint64_t NUMERIC_ATTRIBUTES =
+  attribute_bit(ha_attr_type::supported_features) |
+  attribute_bit(ha_attr_type::brightness) |
+  attribute_bit(ha_attr_type::min_mireds) |
+  attribute_bit(ha_attr_type::max_mireds) |
+  attribute_bit(ha_attr_type::color_temp) |
+  attribute_bit(ha_attr_type::current_position) |
+  attribute_bit(ha_attr_type::position) |
+  attribute_bit(ha_attr_type::current_tilt_position) |
+  attribute_bit(ha_attr_type::tilt_position) |
+  attribute_bit(ha_attr_type::temperature) |
+  attribute_bit(ha_attr_type::current_temperature) |
+  attribute_bit(ha_attr_type::target_temp_high) |
+  attribute_bit(ha_attr_type::target_temp_low) |
+  attribute_bit(ha_attr_type::target_temp_step) |
+  attribute_bit(ha_attr_type::min_temp) |
+  attribute_bit(ha_attr_type::max_temp) |
+  attribute_bit(ha_attr_type::volume_level) |
+  attribute_bit(ha_attr_type::min) |
+  attribute_bit(ha_attr_type::max) |
+  attribute_bit(ha_attr_type::value) |
+  attribute_bit(ha_attr_type::percentage) |
+  attribute_bit(ha_attr_type::percentage_step);
+
+static constexpr uint64_t LIST_ATTRIBUTES = attribute_bits(
+  ha_attr_type::supported_color_modes,
+  ha_attr_type::effect_list,
+  ha_attr_type::preset_modes,
+  ha_attr_type::swing_modes,
+  ha_attr_type::fan_modes,
+  ha_attr_type::hvac_modes,
+  ha_attr_type::source_list,
+  ha_attr_type::options);
+static constexpr uint64_t NORMALISED_ATTRIBUTES = LIST_ATTRIBUTES |
+  attribute_bits(ha_attr_type::brightness, ha_attr_type::color_temp);
+
+bool Entity::is_numeric_attribute(ha_attr_type attr) {
+  return (NUMERIC_ATTRIBUTES & attribute_bit(attr)) != 0;
+}
+
+bool Entity::is_list_attribute(ha_attr_type attr) {
+  return (LIST_ATTRIBUTES & attribute_bit(attr)) != 0;
+}
+
+bool Entity::is_normalised_attribute(ha_attr_type attr) {
+  return (NORMALISED_ATTRIBUTES & attribute_bit(attr)) != 0;
+}
+
+// The position of the attribute in the value array selected by the mask,
+// (i.e. the number of stored attributes in the mask which come before it)
+size_t Entity::get_attribute_index_(ha_attr_type attr, uint64_t mask) const {
+  return __builtin_popcountll(
+    this->attributes_present_ & mask & (attribute_bit(attr) - 1));
 }
 
 bool Entity::has_attribute(ha_attr_type attr) const {
-  auto it = attributes_.find(attr);
-  return it != attributes_.end();
+  return (this->attributes_present_ & attribute_bit(attr)) != 0;
 }
 
 const std::string &Entity::get_attribute(ha_attr_type attr, const std::string &default_value) const {
-  auto it = attributes_.find(attr);
-  return it == attributes_.end() ? default_value : it->second;
-}
-
-void Entity::set_attribute(ha_attr_type attr, const std::string &value) {
-  if (value.empty() || value == "None" || value == "none") {
-    attributes_.erase(attr);
-    this->notify_attribute_change(attr, "");
-    return;
-  }
-  if (this->attributes_[attr] == value) return;
-
-  if (attr == ha_attr_type::brightness) {
-    this->attributes_[attr] = std::to_string(static_cast<int>(round(
-        scale_value(std::stoi(value), {0, 255}, {0, 100}))));
-  } else if (attr == ha_attr_type::color_temp) {
-    auto &minstr = this->get_attribute(ha_attr_type::min_mireds);
-    auto &maxstr = this->get_attribute(ha_attr_type::max_mireds);
-    uint16_t min_mireds = minstr.empty() ? 153 : std::stoi(minstr);
-    uint16_t max_mireds = maxstr.empty() ? 500 : std::stoi(maxstr);
-    this->attributes_[attr] = std::to_string(static_cast<int>(round(scale_value(
-        std::stoi(value),
-        {static_cast<double>(min_mireds), static_cast<double>(max_mireds)},
-        {0, 100}))));
-  } else if (attr == ha_attr_type::supported_color_modes ||
-      attr == ha_attr_type::effect_list ||
-      attr == ha_attr_type::preset_modes ||
-      attr == ha_attr_type::swing_modes ||
-      attr == ha_attr_type::fan_modes ||
-      attr == ha_attr_type::hvac_modes ||
-      // todo: this list can contain any value (including ones with commas),
-      //       convert_python_arr_str does not support this scenario!
-      attr == ha_attr_type::source_list ||
-      attr == ha_attr_type::options) {
-    // todo: remove this when esphome starts sending properly formatted array strings
-    this->attributes_[attr] = convert_python_arr_str(value);
-    
-    // only store the first 14 effects as additonal ones will never be rendered
-    if (attr == ha_attr_type::effect_list) {
-      auto split_pos = find_nth_of(',', 15, this->attributes_[attr]);
-      if (split_pos != std::string::npos) {
-        this->attributes_[attr] = this->attributes_[attr].substr(0, split_pos);
-      }
+  if (!this->has_attribute(attr)) return default_value;
+  return this->attribute_values_[this->get_attribute_index_(attr, ALL_ATTRIBUTES)];
+}
+
+float Entity::get_attribute_number(ha_attr_type attr, float default_value) const {
+  if (!is_numeric_attribute(attr) || !this->has_attribute(attr)) return default_value;
+  auto value = this->attribute_numbers_[this->get_attribute_index_(attr, NUMERIC_ATTRIBUTES)];
+  return std::isnan(value) ? default_value : value;
+}
+
+StringListView Entity::get_attribute_list(ha_attr_type attr) const {
+  if (!is_list_attribute(attr) || !this->has_attribute(attr)) return {};
+  return StringListView(
+    this->attribute_values_[this->get_attribute_index_(attr, ALL_ATTRIBUTES)],
+    this->attribute_list_offsets_[this->get_attribute_index_(attr, LIST_ATTRIBUTES)]);
+}
+
+void Entity::erase_attribute_(ha_attr_type attr) {
+  if (!this->has_attribute(attr)) return;
+  this->attribute_values_.erase(this->attribute_values_.begin() +
+    this->get_attribute_index_(attr, ALL_ATTRIBUTES));
+  if (is_numeric_attribute(attr)) {
+    this->attribute_numbers_.erase(this->attribute_numbers_.begin() +
+      this->get_attribute_index_(attr, NUMERIC_ATTRIBUTES));
+  }
+  if (is_list_attribute(attr)) {
+    this->attribute_list_offsets_.erase(this->attribute_list_offsets_.begin() +
+      this->get_attribute_index_(attr, LIST_ATTRIBUTES));
+  }
+  if (is_normalised_attribute(attr)) {
+    this->attribute_fingerprints_.erase(this->attribute_fingerprints_.begin() +
+      this->get_attribute_index_(attr, NORMALISED_ATTRIBUTES));
+  }
+  this->attributes_present_ &= ~attribute_bit(attr);
+}
+
+static inline bool is_none_value(const std::string &value) {
+  return value.empty() || value == "None" || value == "none";
+}
+
+bool Entity::clear_attribute_(ha_attr_type attr) {
+  if (!this->has_attribute(attr)) {
+    duplicate_attribute_updates_++;
+    return false;
+  }
+  this->erase_attribute_(attr);
+  this->notify_attribute_change(attr, "");
+  return true;
+}
+
+Entity::parsed_list Entity::parse_list_attribute(ha_attr_type attr, std::string value) {
+  parsed_list list;
+  if (!is_list_attribute(attr) || is_none_value(value)) return list;
+  list.fingerprint = fnv1a_hash(value);
+  // the list is parsed in place, only the offsets of the items are allocated
+  // note: only the first 15 effects are stored as additonal ones will never be rendered
+  parse_python_list(value, list.offsets,
+    attr == ha_attr_type::effect_list ? 15u : SIZE_MAX);
+  list.offsets.shrink_to_fit();
+  value.shrink_to_fit();
+  list.items = std::move(value);
+  return list;
+}
+
+bool Entity::set_attribute(ha_attr_type attr, parsed_list list) {
+  if (!is_list_attribute(attr)) return false;
+  if (list.offsets.empty()) {
+    return this->clear_attribute_(attr);
+  }
+
+  const size_t index = this->get_attribute_index_(attr, ALL_ATTRIBUTES);
+  const size_t list_index = this->get_attribute_index_(attr, LIST_ATTRIBUTES);
+  const size_t fingerprint_index = this->get_attribute_index_(attr, NORMALISED_ATTRIBUTES);
+  const bool existed = this->has_attribute(attr);
+  if (!existed) {
+    this->attribute_values_.emplace(this->attribute_values_.begin() + index);
+    this->attribute_list_offsets_.emplace(
+      this->attribute_list_offsets_.begin() + list_index);
+    this->attribute_fingerprints_.insert(
+      this->attribute_fingerprints_.begin() + fingerprint_index, 0);
+    this->attributes_present_ |= attribute_bit(attr);
+  } else if (this->attribute_fingerprints_[fingerprint_index] == list.fingerprint) {
+    duplicate_attribute_updates_++;
+    return false;
+  }
+
+  auto &stored = this->attribute_values_[index];
+  auto &offsets = this->attribute_list_offsets_[list_index];
+  this->attribute_fingerprints_[fingerprint_index] = list.fingerprint;
+  if (existed && list.items == stored && list.offsets == offsets) {
+    duplicate_attribute_updates_++;
+    return false;
+  }
+  stored = std::move(list.items);
+  offsets = std::move(list.offsets);
+
+  if (this->enable_notifications_) {
+    this->notify_attribute_change(attr, stored);
+  }
+  return true;
+}
+
+bool Entity::record_list_update(ha_attr_type attr, const std::string &value) {
+  if (!is_list_attribute(attr)) return true;
+  if (this->list_update_fingerprints_.empty()) {
+    this->list_update_fingerprints_.resize(__builtin_popcountll(LIST_ATTRIBUTES));
+  }
+  auto &last = this->list_update_fingerprints_[
+    __builtin_popcountll(LIST_ATTRIBUTES & (attribute_bit(attr) - 1))];
+  const uint32_t fingerprint = is_none_value(value) ? 0 : fnv1a_hash(value);
+  if (last == fingerprint) {
+    duplicate_attribute_updates_++;
+    return false;
+  }
+  last = fingerprint;
+  return true;
+}
+
+bool Entity::set_attribute(ha_attr_type attr, std::string value) {
+  if (is_none_value(value)) {
+    return this->clear_attribute_(attr);
+  }
+  if (is_list_attribute(attr)) {
+    // drop duplicates before parsing them
+    if (this->has_attribute(attr) && this->attribute_fingerprints_[
+        this->get_attribute_index_(attr, NORMALISED_ATTRIBUTES)] == fnv1a_hash(value)) {
+      duplicate_attribute_updates_++;
+      return false;
     }
-    this->attributes_[attr].shrink_to_fit();
+    return this->set_attribute(attr, parse_list_attribute(attr, std::move(value)));
+  }
+
+  const bool numeric = is_numeric_attribute(attr);
+  const bool normalised = is_normalised_attribute(attr);
+  const uint32_t fingerprint = normalised ? fnv1a_hash(value) : 0;
+  const size_t index = this->get_attribute_index_(attr, ALL_ATTRIBUTES);
+  const size_t number_index = this->get_attribute_index_(attr, NUMERIC_ATTRIBUTES);
+  const size_t fingerprint_index = this->get_attribute_index_(attr, NORMALISED_ATTRIBUTES);
+  const bool existed = this->has_attribute(attr);
+  if (!existed) {
+    this->attribute_values_.emplace(this->attribute_values_.begin() + index);
+    if (numeric) {
+      this->attribute_numbers_.insert(
+        this->attribute_numbers_.begin() + number_index, NAN);
+    }
+    if (normalised) {
+      this->attribute_fingerprints_.insert(
+        this->attribute_fingerprints_.begin() + fingerprint_index, 0);
+    }
+    this->attributes_present_ |= attribute_bit(attr);
+  } else if (normalised
+      ? this->attribute_fingerprints_[fingerprint_index] == fingerprint
+      : this->attribute_values_[index] == value) {
+    // HA sends every attribute again when it reconnects
+    duplicate_attribute_updates_++;
+    return false;
+  }
+  auto &stored = this->attribute_values_[index];
+
+  float number = NAN;
+  std::string normalised_value;
+  if (attr == ha_attr_type::brightness && parse_float(value, number)) {
+    number = round(scale_value(number, {0, 255}, {0, 100}));
+    normalised_value = std::to_string(static_cast<int>(number));
+  } else if (attr == ha_attr_type::color_temp && parse_float(value, number)) {
+    auto min_mireds = this->get_attribute_number(ha_attr_type::min_mireds, 153);
+    auto max_mireds = this->get_attribute_number(ha_attr_type::max_mireds, 500);
+    number = round(scale_value(number,
+        {static_cast<double>(min_mireds), static_cast<double>(max_mireds)},
+        {0, 100}));
+    normalised_value = std::to_string(static_cast<int>(number));
   } else {
-    this->attributes_[attr] = value;
+    normalised_value = std::move(value);
+    if (numeric && !parse_float(normalised_value, number)) number = NAN;
   }
 
+  if (normalised) {
+    this->attribute_fingerprints_[fingerprint_index] = fingerprint;
+    // a different raw value can still result in the same stored value (e.g. brightness)
+    if (existed && normalised_value == stored) {
+      duplicate_attribute_updates_++;
+      return false;
+    }
+  } else if (attr == ha_attr_type::min_mireds || attr == ha_attr_type::max_mireds) {
+    // color_temp must be rescaled when it is received again
+    if (this->has_attribute(ha_attr_type::color_temp)) {
+      this->attribute_fingerprints_[this->get_attribute_index_(
+        ha_attr_type::color_temp, NORMALISED_ATTRIBUTES)] = 0;
+    }
+  }
+  stored = std::move(normalised_value);
+  if (numeric) this->attribute_numbers_[number_index] = number;
+
   if (this->enable_notifications_) {
-    this->notify_attribute_change(attr, this->attributes_[attr]);
+    this->notify_attribute_change(attr, stored);
   }
+  return true;
 }
 
 void Entity::notify_type_change(const char *type) {
   for (auto iter = this->targets_.begin(); iter != this->targets_.end(); ++iter) {
-    (*iter)->on_entity_type_change(type);
+    iter->target->on_entity_type_change(type);
   }
 }
 
 void Entity::notify_state_change(const std::string &state) {
   for (auto iter = this->targets_.begin(); iter != this->targets_.end(); ++iter) {
-    (*iter)->on_entity_state_change(state);
+    iter->target->on_entity_state_change(state);
   }
 }
 
 void Entity::notify_attribute_change(ha_attr_type attr, const std::string &value) {
+  const uint64_t bit = attribute_bit(attr);
   for (auto iter = this->targets_.begin(); iter != this->targets_.end(); ++iter) {
-    (*iter)->on_entity_attribute_change(attr, value);
+    if ((iter->attribute_mask & bit) == 0) {
+      skipped_attribute_notifications_++;
+      continue;
+    }
+    dispatched_attribute_notifications_++;
+    iter->target->on_entity_attribute_change(attr, value);
   }
 }
 
@@ -2,15 +2,31 @@
 
 #include <stdint.h>
 #include <string>
-#include <map>
+#include <string_view>
 #include <vector>
 
 #include "helpers.h"
+#include "string_list.h"
 #include "types.h"
 
 namespace esphome {
 namespace nspanel_lovelace {
 
+static_assert(sizeof(ha_attr_names) / sizeof(*ha_attr_names) <= 64,
+  "ha_attr_type must fit in a 64-bit attribute mask");
+
+inline constexpr uint64_t attribute_bit(ha_attr_type attr) {
+  return 1ULL << static_cast<uint8_t>(attr);
+}
+
+template<typename... Attrs>
+inline constexpr uint64_t attribute_bits(Attrs... attrs) {
+  return (attribute_bit(attrs) | ... | 0ULL);
+}
+
+static constexpr uint64_t NO_ATTRIBUTES = 0ULL;
+static constexpr uint64_t ALL_ATTRIBUTES = ~0ULL;
+
 struct IEntitySubscriber {
 public:
   virtual ~IEntitySubscriber() {}
@@ -24,8 +40,19 @@ public:
   Entity(const std::string &entity_id);
   Entity(const std::string &entity_id, const char *type);
 
-  void add_subscriber(IEntitySubscriber *const target);
+  // The subscriber is only notified of changes to the attributes in
+  // attribute_mask (see attribute_bit), type and state changes are always notified
+  void add_subscriber(IEntitySubscriber *const target,
+      uint64_t attribute_mask = ALL_ATTRIBUTES);
   bool remove_subscriber(const IEntitySubscriber *const target);
+  bool set_subscriber_attribute_mask(
+      const IEntitySubscriber *const target, uint64_t attribute_mask);
+
+  // Number of attribute change notifications delivered/skipped (all entities)
+  static uint32_t get_dispatched_attribute_notifications() { return dispatched_attribute_notifications_; }
+  static uint32_t get_skipped_attribute_notifications() { return skipped_attribute_notifications_; }
+  // Number of attribute updates dropped because the value didn't change (all entities)
+  static uint32_t get_duplicate_attribute_updates() { return duplicate_attribute_updates_; }
 
   const std::string &get_entity_id() const;
   void set_entity_id(const std::string &entity_id);
@@ -34,22 +61,88 @@ public:
   const char *get_type() const;
   bool set_type(const char *type);
 
-  bool is_state(const std::string &state) const;
+  bool is_state(entity_state_t state) const { return this->state_id_ == state; }
+  bool is_state(std::string_view state) const;
+  entity_state_t get_state_id() const { return this->state_id_; }
   const std::string &get_state() const;
-  void set_state(const std::string &state);
+  // note: the values are moved into storage, pass rvalues to avoid copies
+  // Returns false when the state is unchanged
+  bool set_state(std::string state);
 
   bool has_attribute(ha_attr_type attr) const;
   const std::string &get_attribute(ha_attr_type attr, const std::string &default_value = "") const;
-  void set_attribute(ha_attr_type attr, const std::string &value);
+  // Numeric attributes are parsed once when they are set. Returns the default
+  // value if the attribute is not set, not numeric or could not be parsed.
+  float get_attribute_number(ha_attr_type attr, float default_value = 0.0f) const;
+  // List attributes are parsed once when they are set. The view is empty if
+  // the attribute is not set or not a list and is only valid until it changes.
+  StringListView get_attribute_list(ha_attr_type attr) const;
+  // Returns false when the stored value is unchanged (e.g. HA sent it again)
+  bool set_attribute(ha_attr_type attr, std::string value);
+
+  // A list attribute value parsed by parse_list_attribute()
+  struct parsed_list {
+    std::string items;
+    std::vector<uint16_t> offsets;
+    // hash of the value received from HA
+    uint32_t fingerprint = 0;
+  };
+  // Only depends on the arguments, so lists can be parsed on another task
+  // and stored with set_attribute() afterwards
+  static parsed_list parse_list_attribute(ha_attr_type attr, std::string value);
+  bool set_attribute(ha_attr_type attr, parsed_list list);
+  // Records a list attribute value before it is passed to parse_list_attribute().
+  // Returns false when it is the same as the last value recorded, so duplicates are
+  // dropped before parsing even while earlier updates are still being parsed.
+  bool record_list_update(ha_attr_type attr, const std::string &value);
+
+  static bool is_numeric_attribute(ha_attr_type attr);
+  static bool is_list_attribute(ha_attr_type attr);
+  // Attributes which are stored in a different form than HA sends them
+  static bool is_normalised_attribute(ha_attr_type attr);
+
+  // The entity is the subject of a card (alarm, thermo or media card)
+  // which renders more of its attributes than the other cards
+  bool is_card_entity() const { return this->card_entity_; }
+  void set_card_entity(bool value) { this->card_entity_ = value; }
 
 protected:
   std::string entity_id_;
   const char *type_;
   bool type_overridden_ = false;
+  entity_state_t state_id_ = entity_state_t::unknown;
+  // only used for free text states (entity_state_t::other)
   std::string state_;
-  std::map<ha_attr_type, std::string> attributes_;
-  std::vector<IEntitySubscriber*> targets_;
+  // bit n is set when a value is stored for ha_attr_type n
+  uint64_t attributes_present_ = 0;
+  // the values of the stored attributes ordered by ha_attr_type
+  std::vector<std::string> attribute_values_;
+  // the parsed values of the stored numeric attributes ordered by ha_attr_type
+  std::vector<float> attribute_numbers_;
+  // the item end offsets of the stored list attributes ordered by ha_attr_type
+  std::vector<std::vector<uint16_t>> attribute_list_offsets_;
+  // hash of the value received from HA for the stored normalised attributes
+  // (ordered by ha_attr_type), so duplicates are dropped before normalising
+  std::vector<uint32_t> attribute_fingerprints_;
+  // hash of the last value passed to record_list_update() for every list attribute
+  // (ordered by ha_attr_type, 0 for empty values), allocated on first use
+  std::vector<uint32_t> list_update_fingerprints_;
+  struct subscription {
+    IEntitySubscriber *target;
+    uint64_t attribute_mask;
+  };
+  std::vector<subscription> targets_;
   bool enable_notifications_ = false;
+  bool card_entity_ = false;
+
+  static uint32_t dispatched_attribute_notifications_;
+  static uint32_t skipped_attribute_notifications_;
+  static uint32_t duplicate_attribute_updates_;
+
+  size_t get_attribute_index_(ha_attr_type attr, uint64_t mask) const;
+  void erase_attribute_(ha_attr_type attr);
+  // Removes the attribute after HA sent an empty value
+  bool clear_attribute_(ha_attr_type attr);
 
   void notify_type_change(const char *type);
   void notify_state_change(const std::string &state);
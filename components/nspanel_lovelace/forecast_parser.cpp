@@ -0,0 +1,197 @@
+#include "forecast_parser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+bool ForecastParser::parse(std::string_view json, size_t max_items) {
+  this->json_ = json;
+  this->pos_ = 0;
+  this->count_ = 0;
+  this->error_ = nullptr;
+  this->error_pos_ = 0;
+  max_items = std::min(max_items, MAX_ITEMS);
+
+  this->skip_whitespace_();
+  if (!this->consume_('[')) return this->fail_("expected an array");
+  this->skip_whitespace_();
+  if (this->consume_(']')) return true;
+
+  while (this->count_ < max_items) {
+    if (!this->parse_item_(this->items_[this->count_])) return false;
+    this->count_++;
+    this->skip_whitespace_();
+    if (this->consume_(']')) break;
+    if (!this->consume_(',')) return this->fail_("expected ',' or ']'");
+    this->skip_whitespace_();
+  }
+  return true;
+}
+
+bool ForecastParser::parse_item_(weather_forecast_item &item) {
+  item.datetime[0] = '\0';
+  item.condition[0] = '\0';
+  item.temperature = NAN;
+
+  if (!this->consume_('{')) return this->fail_("expected an object");
+  this->skip_whitespace_();
+  if (this->consume_('}')) return true;
+
+  do {
+    this->skip_whitespace_();
+    std::string_view key;
+    if (!this->read_string_(key)) return false;
+    this->skip_whitespace_();
+    if (!this->consume_(':')) return this->fail_("expected ':'");
+    this->skip_whitespace_();
+
+    bool ok;
+    if (key == "datetime" && this->pos_ < this->json_.size() && this->json_[this->pos_] == '"') {
+      ok = this->read_string_(item.datetime, sizeof(item.datetime));
+    } else if (key == "condition" && this->pos_ < this->json_.size() && this->json_[this->pos_] == '"') {
+      ok = this->read_string_(item.condition, sizeof(item.condition));
+    } else if (key == "temperature") {
+      ok = this->read_number_(item.temperature);
+    } else {
+      ok = this->skip_value_();
+    }
+    if (!ok) return false;
+    this->skip_whitespace_();
+  } while (this->consume_(','));
+
+  if (!this->consume_('}')) return this->fail_("expected ',' or '}'");
+  return true;
+}
+
+// Reads a string without decoding it (used for keys)
+bool ForecastParser::read_string_(std::string_view &raw) {
+  if (!this->consume_('"')) return this->fail_("expected a string");
+  const size_t start = this->pos_;
+  while (this->pos_ < this->json_.size()) {
+    const char c = this->json_[this->pos_++];
+    if (c == '"') {
+      raw = this->json_.substr(start, this->pos_ - start - 1);
+      return true;
+    }
+    if (c == '\\') this->pos_++;
+  }
+  return this->fail_("unterminated string");
+}
+
+// Reads a string into the buffer, the value is truncated if it doesn't fit
+// note: unicode escapes are replaced with '?', the values used are plain ascii
+bool ForecastParser::read_string_(char *buffer, size_t size) {
+  std::string_view raw;
+  if (!this->read_string_(raw)) return false;
+
+  size_t len = 0;
+  for (size_t i = 0; i < raw.size() && len + 1 < size; i++) {
+    char c = raw[i];
+    if (c == '\\' && i + 1 < raw.size()) {
+      c = raw[++i];
+      switch (c) {
+      case 'b': c = '\b'; break;
+      case 'f': c = '\f'; break;
+      case 'n': c = '\n'; break;
+      case 'r': c = '\r'; break;
+      case 't': c = '\t'; break;
+      case 'u': c = '?'; i += 4; break;
+      default: break;
+      }
+    }
+    buffer[len++] = c;
+  }
+  buffer[len] = '\0';
+  return true;
+}
+
+// Reads a number (or a string containing a number), anything else is NAN
+bool ForecastParser::read_number_(float &value) {
+  value = NAN;
+  if (this->pos_ < this->json_.size() && this->json_[this->pos_] == '"') {
+    char buffer[16];
+    if (!this->read_string_(buffer, sizeof(buffer))) return false;
+    char *end = nullptr;
+    const float number = std::strtof(buffer, &end);
+    if (end != buffer && *end == '\0') value = number;
+    return true;
+  }
+
+  const size_t start = this->pos_;
+  if (!this->skip_value_()) return false;
+  char buffer[16];
+  const size_t len = this->pos_ - start;
+  if (len == 0 || len >= sizeof(buffer)) return true;
+  this->json_.copy(buffer, len, start);
+  buffer[len] = '\0';
+  char *end = nullptr;
+  const float number = std::strtof(buffer, &end);
+  if (end != buffer && *end == '\0') value = number;
+  return true;
+}
+
+// Skips a value of any type (objects and arrays are skipped as a whole)
+bool ForecastParser::skip_value_() {
+  if (this->pos_ >= this->json_.size()) return this->fail_("expected a value");
+  const char c = this->json_[this->pos_];
+  if (c == '"') {
+    std::string_view raw;
+    return this->read_string_(raw);
+  }
+  if (c == '{' || c == '[') {
+    size_t depth = 0;
+    while (this->pos_ < this->json_.size()) {
+      const char n = this->json_[this->pos_];
+      if (n == '"') {
+        std::string_view raw;
+        if (!this->read_string_(raw)) return false;
+        continue;
+      }
+      this->pos_++;
+      if (n == '{' || n == '[') {
+        depth++;
+      } else if (n == '}' || n == ']') {
+        if (--depth == 0) return true;
+      }
+    }
+    return this->fail_("unterminated value");
+  }
+
+  // numbers, true, false and null
+  const size_t start = this->pos_;
+  while (this->pos_ < this->json_.size()) {
+    const char n = this->json_[this->pos_];
+    if (n == ',' || n == '}' || n == ']' || n == ' ' ||
+        n == '\t' || n == '\r' || n == '\n')
+      break;
+    this->pos_++;
+  }
+  if (this->pos_ == start) return this->fail_("expected a value");
+  return true;
+}
+
+void ForecastParser::skip_whitespace_() {
+  while (this->pos_ < this->json_.size()) {
+    const char c = this->json_[this->pos_];
+    if (c != ' ' && c != '\t' && c != '\r' && c != '\n') return;
+    this->pos_++;
+  }
+}
+
+bool ForecastParser::consume_(char c) {
+  if (this->pos_ >= this->json_.size() || this->json_[this->pos_] != c) return false;
+  this->pos_++;
+  return true;
+}
+
+bool ForecastParser::fail_(const char *error) {
+  this->error_ = error;
+  this->error_pos_ = this->pos_;
+  return false;
+}
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
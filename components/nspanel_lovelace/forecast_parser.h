@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+
+#include "config.h"
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+struct weather_forecast_item {
+  // e.g. 2023-08-22T21:00:00+00:00
+  char datetime[32];
+  char condition[24];
+  float temperature;
+};
+
+/**
+ * Extracts the forecast items from the weather 'forecast' attribute
+ * (a JSON array of objects) without building a JSON document.
+ *
+ * The JSON is walked once and only 'datetime', 'condition' and 'temperature'
+ * of the first items are kept in fixed size buffers (longer values are
+ * truncated). Parsing stops as soon as enough items have been read so the
+ * rest of the JSON is never examined.
+ */
+class ForecastParser {
+public:
+  static constexpr size_t MAX_ITEMS = WEATHER_FORECAST_MAX_ITEMS;
+
+  // Returns false if the JSON is malformed before max_items were read,
+  // the items read up to that point are still available.
+  bool parse(std::string_view json, size_t max_items = MAX_ITEMS);
+
+  size_t size() const { return this->count_; }
+  const weather_forecast_item &operator[](size_t index) const { return this->items_[index]; }
+
+  const char *get_error() const { return this->error_; }
+  // Position of the error in the JSON
+  size_t get_error_position() const { return this->error_pos_; }
+
+protected:
+  bool parse_item_(weather_forecast_item &item);
+  bool read_string_(std::string_view &raw);
+  bool read_string_(char *buffer, size_t size);
+  bool read_number_(float &value);
+  bool skip_value_();
+  void skip_whitespace_();
+  bool consume_(char c);
+  bool fail_(const char *error);
+
+  std::string_view json_;
+  size_t pos_ = 0;
+  std::array<weather_forecast_item, MAX_ITEMS> items_;
+  size_t count_ = 0;
+  const char *error_ = nullptr;
+  size_t error_pos_ = 0;
+};
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
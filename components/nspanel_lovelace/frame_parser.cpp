@@ -0,0 +1,142 @@
+#include "frame_parser.h"
+
+#include <algorithm>
+
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include "crc16.h"
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+static const char *const TAG = "nspanel_lovelace";
+
+// Nextion startup event
+static constexpr uint8_t NEXTION_STARTUP_SEQ[] = {0x00,0x00,0x00,0xFF,0xFF,0xFF};
+// Nextion ready event
+// note: This event can be removed by custom firmware and may never occur
+static constexpr uint8_t NEXTION_READY_SEQ[] = {0x88,0xFF,0xFF,0xFF};
+
+void FrameParser::reset() {
+  this->buffer_.clear();
+  this->state_ = parse_state::header;
+  this->length_ = 0;
+  this->discarded_ = 0;
+  this->resync_window_ = 0;
+}
+
+frame_result FrameParser::parse() {
+  auto &buf = this->buffer_;
+  while (!buf.empty()) {
+    switch (this->state_) {
+    case parse_state::header: {
+      uint8_t first = buf.peek(0);
+      if (first == NEXTION_STARTUP_SEQ[0]) {
+        return this->match_sequence_(NEXTION_STARTUP_SEQ,
+          sizeof(NEXTION_STARTUP_SEQ), frame_result::nextion_startup);
+      }
+      if (first == NEXTION_READY_SEQ[0]) {
+        return this->match_sequence_(NEXTION_READY_SEQ,
+          sizeof(NEXTION_READY_SEQ), frame_result::nextion_ready);
+      }
+      if (first != FRAME_HEADER1) return this->resync_(1);
+      if (buf.size() < 2) return frame_result::incomplete;
+      if (buf.peek(1) != FRAME_HEADER2) return this->resync_(2);
+      this->state_ = parse_state::length;
+      break;
+    }
+    case parse_state::length:
+      if (buf.size() < FRAME_HEADER_SIZE) return frame_result::incomplete;
+      this->length_ = encode_uint16(buf.peek(3), buf.peek(2));
+      if (this->length_ > FRAME_MAX_PAYLOAD_SIZE) {
+        return this->resync_(FRAME_HEADER_SIZE);
+      }
+      this->state_ = parse_state::payload;
+      break;
+    case parse_state::payload: {
+      const size_t frame_size = FRAME_HEADER_SIZE + this->length_;
+      // Wait until all data comes in
+      if (buf.size() < frame_size + FRAME_CRC_SIZE) return frame_result::incomplete;
+
+      buf.copy_to(this->frame_.data(), 0, frame_size);
+      uint16_t crc16 = encode_uint16(buf.peek(frame_size + 1), buf.peek(frame_size));
+      uint16_t calculated_crc16 = Crc16::calculate(this->frame_.data(), frame_size);
+      if (crc16 != calculated_crc16) {
+        ESP_LOGW(TAG, "Received invalid message checksum %02X!=%02X", crc16, calculated_crc16);
+        return this->resync_(frame_size + FRAME_CRC_SIZE);
+      }
+      return this->complete_(frame_size + FRAME_CRC_SIZE, frame_result::frame);
+    }
+    }
+  }
+  return frame_result::incomplete;
+}
+
+frame_result FrameParser::match_sequence_(const uint8_t *seq, size_t len, frame_result result) {
+  auto &buf = this->buffer_;
+  size_t at = 0;
+  for (; at < len && at < buf.size(); at++) {
+    if (buf.peek(at) != seq[at]) return this->resync_(at + 1);
+  }
+  if (at < len) return frame_result::incomplete;
+  return this->complete_(len, result);
+}
+
+frame_result FrameParser::complete_(size_t len, frame_result result) {
+  if (this->resync_window_ > 0) {
+    this->recovered_count_++;
+    this->resync_window_ = 0;
+  }
+  this->buffer_.pop(len);
+  this->state_ = parse_state::header;
+  return result;
+}
+
+bool FrameParser::is_frame_start_(size_t offset) const {
+  auto &buf = this->buffer_;
+  const uint8_t *seq;
+  size_t len;
+  switch (buf.peek(offset)) {
+  case FRAME_HEADER1:
+    return offset + 1 >= buf.size() || buf.peek(offset + 1) == FRAME_HEADER2;
+  case NEXTION_STARTUP_SEQ[0]:
+    seq = NEXTION_STARTUP_SEQ;
+    len = sizeof(NEXTION_STARTUP_SEQ);
+    break;
+  case NEXTION_READY_SEQ[0]:
+    seq = NEXTION_READY_SEQ;
+    len = sizeof(NEXTION_READY_SEQ);
+    break;
+  default:
+    return false;
+  }
+  // a partial sequence at the end of the buffer could still be valid
+  for (size_t i = 1; i < len && offset + i < buf.size(); i++) {
+    if (buf.peek(offset + i) != seq[i]) return false;
+  }
+  return true;
+}
+
+frame_result FrameParser::resync_(size_t examined) {
+  auto &buf = this->buffer_;
+  if (examined > buf.size()) examined = buf.size();
+
+  // Search for the next header (or Nextion event) instead of dropping
+  // everything examined so far, a valid frame may have started inside it
+  size_t skip = 1;
+  while (skip < buf.size() && !this->is_frame_start_(skip)) skip++;
+
+  this->resync_count_++;
+  size_t window = std::max(examined, this->resync_window_);
+  this->resync_window_ = skip < window ? window - skip : 0;
+
+  buf.copy_to(this->frame_.data(), 0, skip);
+  buf.pop(skip);
+  this->discarded_ = skip;
+  this->state_ = parse_state::header;
+  return frame_result::invalid;
+}
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
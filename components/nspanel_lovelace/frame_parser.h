@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "ring_buffer.h"
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+// Frame layout: 0x55 0xBB [length LE uint16] [payload] [crc16 LE uint16]
+constexpr uint8_t FRAME_HEADER1 = 0x55;
+constexpr uint8_t FRAME_HEADER2 = 0xBB;
+constexpr size_t FRAME_HEADER_SIZE = 4u;
+constexpr size_t FRAME_CRC_SIZE = 2u;
+constexpr size_t FRAME_MAX_PAYLOAD_SIZE =
+  UART_RX_BUFFER_SIZE - FRAME_HEADER_SIZE - FRAME_CRC_SIZE;
+
+enum class frame_result : uint8_t {
+  // more data is required
+  incomplete,
+  // a valid frame is available (see get_payload())
+  frame,
+  nextion_startup,
+  nextion_ready,
+  // data was discarded up to the next possible frame (see get_discarded_data())
+  invalid
+};
+
+/**
+ * Incremental parser for frames sent by the display.
+ *
+ * Data is read from the UART in bulk into the ring buffer, then parse()
+ * is called until it returns 'incomplete'. The parser state is kept between
+ * calls so bytes are only examined once the header, length or
+ * whole frame have been received.
+ */
+class FrameParser {
+public:
+  using buffer_type = RingBuffer<UART_RX_BUFFER_SIZE>;
+
+  buffer_type &get_buffer() { return this->buffer_; }
+
+  frame_result parse();
+  void reset();
+
+  // Only valid after parse() returns 'frame'
+  const uint8_t *get_payload() const { return &this->frame_[FRAME_HEADER_SIZE]; }
+  uint16_t get_payload_length() const { return this->length_; }
+
+  // Only valid after parse() returns 'invalid'
+  const uint8_t *get_discarded_data() const { return this->frame_.data(); }
+  size_t get_discarded_length() const { return this->discarded_; }
+
+  // Number of times the parser had to search for the next frame header
+  uint32_t get_resync_count() const { return this->resync_count_; }
+  // Number of frames (or Nextion events) found inside data that failed to parse
+  uint32_t get_recovered_count() const { return this->recovered_count_; }
+
+protected:
+  enum class parse_state : uint8_t { header, length, payload };
+
+  frame_result match_sequence_(const uint8_t *seq, size_t len, frame_result result);
+  frame_result complete_(size_t len, frame_result result);
+  // Discards data up to the next possible frame start after the
+  // first 'examined' bytes failed to parse
+  frame_result resync_(size_t examined);
+  bool is_frame_start_(size_t offset) const;
+
+  buffer_type buffer_;
+  // linear copy of the last frame (or discarded data)
+  std::array<uint8_t, UART_RX_BUFFER_SIZE> frame_{};
+  parse_state state_ = parse_state::header;
+  uint16_t length_ = 0;
+  size_t discarded_ = 0;
+  // bytes remaining from the last failed parse attempt, any frame starting
+  // within these bytes would have been lost without resyncing
+  size_t resync_window_ = 0;
+  uint32_t resync_count_ = 0;
+  uint32_t recovered_count_ = 0;
+};
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
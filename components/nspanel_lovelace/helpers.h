@@ -11,6 +11,7 @@
 #include <math.h>
 #include <stdint.h>
 #include <string>
+#include <string_view>
 #include <time.h>
 #include <vector>
 
@@ -82,6 +83,14 @@ inline double value_or_default(const std::string &str, double default_value) {
     ? default_value : std::stod(str);
 }
 
+// Parses the whole string as a float, returns false if it isn't a number
+inline bool parse_float(const std::string &str, float &value) {
+  if (str.empty()) return false;
+  char *end = nullptr;
+  value = std::strtof(str.c_str(), &end);
+  return end != str.c_str() && *end == '\0';
+}
+
 inline bool iso8601_to_tm(const char* iso8601_string, tm &t) {
   if (iso8601_string == nullptr) return false;
   
@@ -203,6 +212,36 @@ inline void split_str(char delimiter, const std::string &str, std::vector<std::s
   if (!item.empty()) { array.push_back(str.substr(pos_start)); }
 }
 
+// Splits the string into views without copying or allocating. If there are
+// more than N tokens then the last view contains the remainder of the string.
+// Returns the number of tokens found.
+template<size_t N>
+inline size_t split_str(char delimiter, std::string_view str, std::array<std::string_view, N> &tokens) {
+  static_assert(N > 0, "At least one token is required");
+  size_t count = 0;
+  while (count < N - 1) {
+    auto pos = str.find(delimiter);
+    if (pos == std::string_view::npos) break;
+    tokens[count++] = str.substr(0, pos);
+    str.remove_prefix(pos + 1);
+  }
+  tokens[count++] = str;
+  return count;
+}
+
+static constexpr uint32_t FNV1A_BASIS = 2166136261u;
+
+// 32-bit FNV-1a hash, can be evaluated at compile time.
+// A different basis can be used to get an independent hash (used as a seed).
+inline constexpr uint32_t fnv1a_hash(std::string_view str, uint32_t basis = FNV1A_BASIS) {
+  uint32_t hash = basis;
+  for (char c : str) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
 inline size_t find_nth_of(char delimiter, uint16_t count, const std::string &str) {
   size_t pos = std::string::npos;
   if (count == 0) return pos;
@@ -216,28 +255,6 @@ inline size_t find_nth_of(char delimiter, uint16_t count, const std::string &str
   return pos;
 }
 
-// Takes the string representation of a Python array (enums, strings etc) and extracts the 
-// values to a new string separated by delimiter.
-// todo: remove this when esphome starts sending properly formatted array strings
-inline std::string convert_python_arr_str(const std::string &str, const char delimiter = ',') {
-  if (str.empty()) return str;
-  size_t pos_start = std::string::npos, pos_end = pos_start;
-  std::string tmp;
-  do {
-      pos_start = str.find('\'', pos_end + 1);
-      if (pos_start == std::string::npos) {
-        if (tmp.back() == delimiter) tmp.pop_back();
-        break;
-      }
-      pos_end = str.find('\'', pos_start + 1);
-      if (pos_end == std::string::npos) break;
-      // ignore empty entries
-      if (pos_end - pos_start - 1 == 0) continue;
-      tmp.append(str.substr(pos_start + 1, pos_end - pos_start - 1)).append(1, delimiter);
-  } while (true);
-  return tmp.empty() ? str : tmp;
-}
-
 inline std::string to_string(const std::vector<std::string> &array, 
     char delimiter = ',', const char prepend_char = '\0', 
     const char append_char = '\0') {
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+#include "helpers.h"
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+// Sorted flat map from the hash of a string key to an item.
+// 'KeyFn' returns the key of an item and is used to resolve hash collisions.
+// note: the key of an item must not change while it is in the index
+template<typename T, typename KeyFn>
+class HashIndex {
+public:
+  size_t size() const { return this->entries_.size(); }
+  void clear() { this->entries_.clear(); }
+
+  void insert(T *item) {
+    const uint32_t hash = fnv1a_hash(KeyFn{}(item));
+    auto it = std::upper_bound(this->entries_.begin(), this->entries_.end(), hash,
+      [](uint32_t hash, const entry &e) { return hash < e.hash; });
+    this->entries_.insert(it, {hash, item});
+  }
+
+  T *find(std::string_view key) const {
+    const uint32_t hash = fnv1a_hash(key);
+    auto it = std::lower_bound(this->entries_.begin(), this->entries_.end(), hash,
+      [](const entry &e, uint32_t hash) { return e.hash < hash; });
+    for (; it != this->entries_.end() && it->hash == hash; ++it) {
+      if (KeyFn{}(it->item) == key) return it->item;
+    }
+    return nullptr;
+  }
+
+protected:
+  struct entry {
+    uint32_t hash;
+    T *item;
+  };
+  std::vector<entry> entries_;
+};
+
+// Index of items by uuid. The uuids generated during code generation are
+// numbers so they are used to index a table directly, any other uuids
+// fall back to a HashIndex.
+template<typename T, typename KeyFn>
+class UuidIndex {
+public:
+  // Numeric uuids above this value are stored in the hash index instead
+  static constexpr int32_t MAX_DIRECT_INDEX = 1024;
+
+  size_t size() const {
+    return this->hashed_.size() +
+      std::count_if(this->table_.begin(), this->table_.end(),
+        [](const T *item) { return item != nullptr; });
+  }
+
+  void insert(T *item) {
+    auto index = parse_index(KeyFn{}(item));
+    if (index < 0) {
+      this->hashed_.insert(item);
+      return;
+    }
+    if (static_cast<size_t>(index) >= this->table_.size())
+      this->table_.resize(index + 1, nullptr);
+    this->table_[index] = item;
+  }
+
+  T *find(std::string_view uuid) const {
+    auto index = parse_index(uuid);
+    if (index < 0) return this->hashed_.find(uuid);
+    if (static_cast<size_t>(index) >= this->table_.size()) return nullptr;
+    return this->table_[index];
+  }
+
+  // Returns the table index of the uuid or -1 if it isn't a (small) number
+  static int32_t parse_index(std::string_view uuid) {
+    // note: leading zeros are not allowed so each number maps to one uuid
+    if (uuid.empty() || uuid.size() > 4 || (uuid.size() > 1 && uuid[0] == '0'))
+      return -1;
+    int32_t index = 0;
+    for (char c : uuid) {
+      if (c < '0' || c > '9') return -1;
+      index = index * 10 + (c - '0');
+    }
+    return index <= MAX_DIRECT_INDEX ? index : -1;
+  }
+
+protected:
+  std::vector<T *> table_;
+  HashIndex<T, KeyFn> hashed_;
+};
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
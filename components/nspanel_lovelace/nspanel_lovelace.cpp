@@ -16,10 +16,10 @@
 #include "esphome/core/application.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/util.h"
-#include "esphome/components/json/json_util.h"
 
 #include "cards.h"
 #include "card_items.h"
+#include "crc16.h"
 #include "pages.h"
 #include "page_item_visitor.h"
 #include "page_visitor.h"
@@ -28,33 +28,87 @@
 namespace esphome {
 namespace nspanel_lovelace {
 
-// Use PSRAM for ArduinoJson (if available, otherwise use normal malloc)
-// see: https://arduinojson.org/v6/how-to/use-external-ram-on-esp32/#how-to-use-the-psram-with-arduinojson
-struct SpiRamAllocator {
-  void* allocate(size_t size) {
-   if (psram_available())
-     return heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
-   else
-     return malloc(size);
-  }
+static const char *const TAG = "nspanel_lovelace";
 
-  void deallocate(void* pointer) {
-    if (psram_available())
-      heap_caps_free(pointer);
-    else
-      return free(pointer);
-  }
+// The Home Assistant state and attributes needed for each entity kind
+struct ha_subscription_plan {
+  entity_kind kind;
+  // attributes used wherever the entity is shown (including popups)
+  uint64_t attributes;
+  // attributes only rendered by the card dedicated to the entity
+  // (alarm, thermo or media card), see Entity::is_card_entity()
+  uint64_t card_attributes;
+};
 
-  void* reallocate(void* ptr, size_t new_size) {
-    if (psram_available())
-      return heap_caps_realloc(ptr, new_size, MALLOC_CAP_SPIRAM);
-    else
-      return realloc(ptr, new_size);
-  }
+static constexpr ha_subscription_plan HA_SUBSCRIPTION_PLANS[] = {
+  {entity_kind::light, attribute_bits(
+      ha_attr_type::supported_color_modes, ha_attr_type::color_mode,
+      ha_attr_type::min_mireds, ha_attr_type::max_mireds, ha_attr_type::color_temp,
+      // need to subscribe to brightness to know if brightness is supported
+      ha_attr_type::brightness, ha_attr_type::effect_list),
+    NO_ATTRIBUTES},
+  {entity_kind::switch_, NO_ATTRIBUTES, NO_ATTRIBUTES},
+  {entity_kind::input_boolean, NO_ATTRIBUTES, NO_ATTRIBUTES},
+  {entity_kind::input_text, NO_ATTRIBUTES, NO_ATTRIBUTES},
+  {entity_kind::text, NO_ATTRIBUTES, NO_ATTRIBUTES},
+  {entity_kind::automation, NO_ATTRIBUTES, NO_ATTRIBUTES},
+  {entity_kind::sun, NO_ATTRIBUTES, NO_ATTRIBUTES},
+  {entity_kind::vacuum, NO_ATTRIBUTES, NO_ATTRIBUTES},
+  {entity_kind::lock, NO_ATTRIBUTES, NO_ATTRIBUTES},
+  {entity_kind::person, NO_ATTRIBUTES, NO_ATTRIBUTES},
+  // icons and unit_of_measurement based on state and device_class
+  {entity_kind::sensor, attribute_bits(
+      ha_attr_type::device_class, ha_attr_type::unit_of_measurement),
+    NO_ATTRIBUTES},
+  {entity_kind::binary_sensor, attribute_bits(
+      ha_attr_type::device_class, ha_attr_type::unit_of_measurement),
+    NO_ATTRIBUTES},
+  {entity_kind::cover, attribute_bits(
+      ha_attr_type::device_class, ha_attr_type::supported_features,
+      ha_attr_type::current_position, ha_attr_type::current_tilt_position),
+    NO_ATTRIBUTES},
+  {entity_kind::alarm_control_panel, NO_ATTRIBUTES, attribute_bits(
+      ha_attr_type::code_arm_required, ha_attr_type::open_sensors)},
+  {entity_kind::timer, attribute_bits(
+      ha_attr_type::editable, ha_attr_type::duration,
+      ha_attr_type::remaining, ha_attr_type::finishes_at),
+    NO_ATTRIBUTES},
+  {entity_kind::climate, attribute_bits(
+      ha_attr_type::temperature, ha_attr_type::current_temperature,
+      // the modes are also shown by the climate popup
+      ha_attr_type::preset_modes, ha_attr_type::swing_modes, ha_attr_type::fan_modes),
+    attribute_bits(
+      ha_attr_type::target_temp_high, ha_attr_type::target_temp_low,
+      ha_attr_type::target_temp_step, ha_attr_type::min_temp, ha_attr_type::max_temp,
+      ha_attr_type::hvac_action, ha_attr_type::hvac_modes)},
+  {entity_kind::media_player, attribute_bits(
+      ha_attr_type::media_content_type,
+      // the sources are also shown by the media player popup
+      ha_attr_type::source_list),
+    attribute_bits(
+      ha_attr_type::supported_features, ha_attr_type::media_title,
+      ha_attr_type::media_artist, ha_attr_type::volume_level,
+      ha_attr_type::shuffle)},
+  {entity_kind::select, attribute_bits(ha_attr_type::options), NO_ATTRIBUTES},
+  {entity_kind::input_select, attribute_bits(ha_attr_type::options), NO_ATTRIBUTES},
+  {entity_kind::number, attribute_bits(ha_attr_type::min, ha_attr_type::max), NO_ATTRIBUTES},
+  {entity_kind::input_number, attribute_bits(ha_attr_type::min, ha_attr_type::max), NO_ATTRIBUTES},
+  {entity_kind::weather, attribute_bits(
+      ha_attr_type::temperature, ha_attr_type::temperature_unit),
+    NO_ATTRIBUTES},
+  {entity_kind::fan, attribute_bits(
+      ha_attr_type::percentage_step, ha_attr_type::percentage,
+      ha_attr_type::preset_modes, ha_attr_type::preset_mode),
+    NO_ATTRIBUTES},
 };
-using SpiRamJsonDocument = BasicJsonDocument<SpiRamAllocator>;
 
-static const char *const TAG = "nspanel_lovelace";
+// Returns nullptr when the entity kind doesn't need any subscriptions
+static const ha_subscription_plan *get_ha_subscription_plan(entity_kind kind) {
+  for (const auto &plan : HA_SUBSCRIPTION_PLANS) {
+    if (plan.kind == kind) return &plan;
+  }
+  return nullptr;
+}
 
 NSPanelLovelace::NSPanelLovelace() {
   command_buffer_.reserve(1024);
@@ -79,8 +133,15 @@ bool NSPanelLovelace::save_state_() {
 
 void NSPanelLovelace::setup() {
   this->default_baud_rate_ = this->parent_->get_baud_rate();
+  this->tx_buffer_.reserve(UART_TX_BUFFER_SIZE);
 
   this->restore_state_();
+  this->worker_.start();
+  if (this->use_uart_rx_task_) {
+    this->uart_receiver_ = std::unique_ptr<UartReceiver>(new UartReceiver());
+    // fall back to reading the UART in loop()
+    if (!this->uart_receiver_->start(this->parent_)) this->uart_receiver_.reset();
+  }
 
 #ifdef USE_TIME
   this->setup_time_();
@@ -88,222 +149,35 @@ void NSPanelLovelace::setup() {
   // todo: create entity for weather instead, so others can subscribe
   if (!this->weather_entity_id_.empty()) {
     // state provides the information for the icon
-    this->subscribe_homeassistant_state(
-        &NSPanelLovelace::on_weather_state_update_, this->weather_entity_id_);
-    this->subscribe_homeassistant_state(
-        &NSPanelLovelace::on_weather_temperature_update_,
-        this->weather_entity_id_, to_string(ha_attr_type::temperature));
-    this->subscribe_homeassistant_state(
-        &NSPanelLovelace::on_weather_temperature_unit_update_,
-        this->weather_entity_id_, to_string(ha_attr_type::temperature_unit));
-    this->subscribe_homeassistant_state(
-        &NSPanelLovelace::on_weather_forecast_update_, this->weather_entity_id_,
-        to_string(ha_attr_type::forecast));
+    this->subscribe_weather_(ha_attr_type::state);
+    this->subscribe_weather_(ha_attr_type::temperature);
+    this->subscribe_weather_(ha_attr_type::temperature_unit);
+    this->subscribe_weather_(ha_attr_type::forecast);
   }
   
-  for (auto &entity : this->entities_) {
-    auto &entity_id = entity->get_entity_id();
-    ESP_LOGV(TAG, "Adding subscriptions for entity '%s'", entity_id.c_str());
-    bool add_state_subscription = false;
-    if (entity->is_type(entity_type::light)) {
-      add_state_subscription = true;
-      this->subscribe_homeassistant_state_attr(
-        &NSPanelLovelace::on_entity_attribute_update_,
-        entity_id, to_string(ha_attr_type::supported_color_modes));
-      this->subscribe_homeassistant_state_attr(
-        &NSPanelLovelace::on_entity_attribute_update_,
-        entity_id, to_string(ha_attr_type::color_mode));
-      this->subscribe_homeassistant_state_attr(
-        &NSPanelLovelace::on_entity_attribute_update_,
-        entity_id, to_string(ha_attr_type::min_mireds));
-      this->subscribe_homeassistant_state_attr(
-        &NSPanelLovelace::on_entity_attribute_update_,
-        entity_id, to_string(ha_attr_type::max_mireds));
-      this->subscribe_homeassistant_state_attr(
-        &NSPanelLovelace::on_entity_attribute_update_,
-        entity_id, to_string(ha_attr_type::color_temp));
-      // need to subscribe to brightness to know if brightness is supported
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::brightness));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::effect_list));
-    }
-    else if (entity->is_type(entity_type::switch_) ||
-        entity->is_type(entity_type::input_boolean) ||
-        entity->is_type(entity_type::input_text) ||
-        entity->is_type(entity_type::text) ||
-        entity->is_type(entity_type::automation) ||
-        entity->is_type(entity_type::sun) ||
-        entity->is_type(entity_type::vacuum) ||
-        entity->is_type(entity_type::lock) ||
-        entity->is_type(entity_type::person)) {
-      add_state_subscription = true;
-    }
-    // icons and unit_of_measurement based on state and device_class
-    else if (entity->is_type(entity_type::sensor) ||
-        entity->is_type(entity_type::binary_sensor)) {
-      add_state_subscription = true;
-      // if (!entity->is_icon_value_overridden()) {
-        this->subscribe_homeassistant_state_attr(
-            &NSPanelLovelace::on_entity_attribute_update_, 
-            entity_id, to_string(ha_attr_type::device_class));
-      // }
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::unit_of_measurement));
-    }
-    else if (entity->is_type(entity_type::cover)) {
-      add_state_subscription = true;
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::device_class));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::supported_features));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::current_position));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::current_tilt_position));
-    }
-    else if (entity->is_type(entity_type::alarm_control_panel)) {
-      add_state_subscription = true;
-      this->subscribe_homeassistant_state_attr(
-        &NSPanelLovelace::on_entity_attribute_update_,
-        entity_id, to_string(ha_attr_type::code_arm_required));
-      this->subscribe_homeassistant_state_attr(
-        &NSPanelLovelace::on_entity_attribute_update_,
-        entity_id, to_string(ha_attr_type::open_sensors));
-    }
-    else if (entity->is_type(entity_type::timer)) {
-      add_state_subscription = true;
-      this->subscribe_homeassistant_state_attr(
-        &NSPanelLovelace::on_entity_attribute_update_,
-        entity_id, to_string(ha_attr_type::editable));
-      this->subscribe_homeassistant_state_attr(
-        &NSPanelLovelace::on_entity_attribute_update_,
-        entity_id, to_string(ha_attr_type::duration));
-      this->subscribe_homeassistant_state_attr(
-        &NSPanelLovelace::on_entity_attribute_update_,
-        entity_id, to_string(ha_attr_type::remaining));
-      this->subscribe_homeassistant_state_attr(
-        &NSPanelLovelace::on_entity_attribute_update_,
-        entity_id, to_string(ha_attr_type::finishes_at));
-    }
-    else if (entity->is_type(entity_type::climate)) {
-      add_state_subscription = true;
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::temperature));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::current_temperature));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::target_temp_high));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::target_temp_low));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::target_temp_step));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::min_temp));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::max_temp));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::hvac_action));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::preset_modes));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::swing_modes));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::fan_modes));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::hvac_modes));
-    }
-    else if (entity->is_type(entity_type::media_player)) {
-      add_state_subscription = true;
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::supported_features));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::media_content_type));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::media_title));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::media_artist));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::volume_level));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::shuffle));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::source_list));
-    }
-    else if (entity->is_type(entity_type::select) ||
-        entity->is_type(entity_type::input_select)) {
-      add_state_subscription = true;
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::options));
-    }
-    else if (entity->is_type(entity_type::number) ||
-        entity->is_type(entity_type::input_number)) {
-      add_state_subscription = true;
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::min));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::max));
-    }
-    else if (entity->is_type(entity_type::weather)) {
-      add_state_subscription = true;
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::temperature));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::temperature_unit));
-    }
-    else if (entity->is_type(entity_type::fan)) {
-      add_state_subscription = true;
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::percentage_step));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::percentage));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::preset_modes));
-      this->subscribe_homeassistant_state_attr(
-          &NSPanelLovelace::on_entity_attribute_update_, 
-          entity_id, to_string(ha_attr_type::preset_mode));
+  const size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  size_t subscription_count = 0, pruned_count = 0;
+  for (size_t index = 0; index < this->entities_.size(); index++) {
+    auto &entity = this->entities_[index];
+    auto plan = get_ha_subscription_plan(to_entity_kind(entity->get_type()));
+    if (plan == nullptr) continue;
+    ESP_LOGV(TAG, "Adding subscriptions for entity '%s'", entity->get_entity_id().c_str());
+
+    uint64_t attributes = plan->attributes;
+    if (entity->is_card_entity()) {
+      attributes |= plan->card_attributes;
+    } else {
+      pruned_count += __builtin_popcountll(plan->card_attributes & ~plan->attributes);
     }
-
-    if (add_state_subscription) {
-      this->subscribe_homeassistant_state(
-        &NSPanelLovelace::on_entity_state_update_,
-        entity_id);
+    for (uint8_t i = 0; attributes != 0; i++, attributes >>= 1) {
+      if ((attributes & 1) == 0) continue;
+      subscription_count += this->subscribe_entity_(index, static_cast<ha_attr_type>(i));
     }
+    subscription_count += this->subscribe_entity_(index, ha_attr_type::state);
   }
+  ESP_LOGI(TAG, "HA entity subscriptions: %zu (%zu before removing attributes no card renders), heap used: %zu bytes",
+      subscription_count, subscription_count + pruned_count,
+      heap_before - std::min(heap_before, heap_caps_get_free_size(MALLOC_CAP_INTERNAL)));
 
   this->set_timeout(1000, [this]() {
     // The display isn't reset when ESP is reset (on ota update etc.)
@@ -329,17 +203,27 @@ void NSPanelLovelace::loop() {
   }
 #endif
 
-  // Monitor for commands arriving from the screen over UART
-  uint8_t d;
-  while (this->available()) {
-    this->read_byte(&d);
-    this->buffer_.push_back(d);
-    if (!this->process_data_()) {
-      ESP_LOGW(TAG, "Unparsed data: %s", esphome::format_hex(this->buffer_).c_str());
-      this->buffer_.clear();
+  if (this->uart_receiver_ != nullptr) {
+    // the frames have already been received by the UART task
+    this->process_uart_receiver_();
+  } else {
+    // Monitor for commands arriving from the screen over UART.
+    // Everything available is read in bulk straight into the receive buffer.
+    auto &rx_buffer = this->frame_parser_.get_buffer();
+    int available;
+    while ((available = this->available()) > 0) {
+      size_t len;
+      uint8_t *data = rx_buffer.write_region(len);
+      if (len == 0) break;
+      len = std::min(len, static_cast<size_t>(available));
+      if (!this->read_array(data, len)) break;
+      rx_buffer.commit(len);
+      this->process_data_();
     }
   }
 
+  this->worker_.loop();
+
   if (this->force_current_page_update_) {
     this->force_current_page_update_ = false;
     ESP_LOGD(TAG, "Render HA update");
@@ -357,28 +241,26 @@ void NSPanelLovelace::loop() {
 }
 
 std::shared_ptr<Entity> NSPanelLovelace::create_entity(const std::string &entity_id) {
-  for (auto &e : this->entities_) {
-    if (entity_id == e->get_entity_id()) return e;
+  if (auto existing = this->entity_index_.find(entity_id)) {
+    // note: only happens during setup so finding the shared pointer is fine
+    for (auto &e : this->entities_) {
+      if (e.get() == existing) return e;
+    }
   }
   auto entity = std::make_shared<Entity>(entity_id);
   this->entities_.push_back(entity);
+  this->entity_index_.insert(entity.get());
   return entity;
 }
 
 void NSPanelLovelace::on_page_item_added_callback(const std::shared_ptr<PageItem> &item) {
-  bool found = false;
   auto &item_uuid = item->get_uuid();
 
-  if (page_item_cast<StatefulPageItem>(item.get())) {
-    for (auto &item : this->stateful_page_items_) {
-      if (item->get_uuid() == item_uuid) {
-        found = true;
-        break;
-      }
-    }
-    if (!found) {
+  if (auto item_ptr = page_item_cast<StatefulPageItem>(item.get())) {
+    if (this->page_item_index_.find(item_uuid) == nullptr) {
       auto& stateful_item = (const std::shared_ptr<StatefulPageItem>&)item;
       this->stateful_page_items_.push_back(stateful_item);
+      this->page_item_index_.insert(item_ptr);
       ESP_LOGV(TAG, "Adding stateful item uuid.%s %s", 
         item_uuid.c_str(),
         stateful_item->get_entity_id().c_str());
@@ -433,109 +315,112 @@ void NSPanelLovelace::set_display_dim(uint8_t inactive, uint8_t active) {
   this->send_buffered_command_();
 }
 
-bool NSPanelLovelace::process_data_() {
-  uint32_t at = this->buffer_.size() - 1;
-  auto *data = &this->buffer_[0];
-  uint8_t new_byte = data[at];
-
-  // Nextion Startup event
-  // todo: store 'tft_connected' state?
-  if (data[0] == 0x0) {
-    if (at > 5) return false;
-    static constexpr uint8_t seq[] = {0x00,0x00,0x00,0xFF,0xFF,0xFF};
-    if (at == 5 && data[at] == seq[at]) {
-      ESP_LOGD(TAG, "Nextion started");
-      this->buffer_.clear();
-    }
-    return data[at] == seq[at];
-  }
-  // Nextion Ready event
-  // note: This event can be removed by custom firmware and may never occur
-  if (data[0] == 0x88) {
-    if (at > 3) return false;
-    static constexpr uint8_t seq[] = {0x88,0xFF,0xFF,0xFF};
-    if (at == 3 && data[at] == seq[at]) {
-      ESP_LOGD(TAG, "Nextion ready");
-      this->buffer_.clear();
+void NSPanelLovelace::process_data_() {
+  auto &parser = this->frame_parser_;
+  while (true) {
+    // note: the payload is only valid until the next call to parse()
+    switch (auto result = parser.parse()) {
+    case frame_result::incomplete:
+      return;
+    case frame_result::frame:
+      this->process_frame_result_(result, parser.get_payload(), parser.get_payload_length());
+      break;
+    case frame_result::invalid:
+      this->process_frame_result_(result, parser.get_discarded_data(), parser.get_discarded_length());
+      break;
+    default:
+      this->process_frame_result_(result, nullptr, 0);
+      break;
     }
-    return data[at] == seq[at];
-  }
-
-  // Byte 0: HEADER1 (always 0x55)
-  if (at == 0)
-    return new_byte == 0x55;
-  // Byte 1: HEADER2 (always 0xBB)
-  if (at == 1)
-    return new_byte == 0xBB;
-
-  // Byte 3 & 4 - length (little endian)
-  if (at == 2 || at == 3) {
-    return true;
   }
-  uint16_t length = encode_uint16(data[3], data[2]);
+}
 
-  // Wait until all data comes in
-  if (at - 4 < length) {
-    //    ESP_LOGD(TAG, "Message (%d/%d): 0x%02x", at - 3, length, new_byte);
-    return true;
+void NSPanelLovelace::process_uart_receiver_() {
+  auto &receiver = *this->uart_receiver_;
+  // note: the message is large, so it is kept off the loop task stack
+  static uart_rx_message message;
+  while (receiver.pop(message)) {
+    this->process_frame_result_(message.result, message.data.data(), message.length);
   }
 
-  // Last two bytes: CRC; return after first one
-  if (at == 4 + length) {
-    return true;
+  const uint32_t dropped = receiver.get_dropped_count();
+  if (dropped != this->uart_rx_dropped_count_) {
+    ESP_LOGW(TAG, "UART messages dropped: %" PRIu32, dropped - this->uart_rx_dropped_count_);
+    this->uart_rx_dropped_count_ = dropped;
   }
+}
 
-  uint16_t crc16 = encode_uint16(data[4 + length + 1], data[4 + length]);
-  uint16_t calculated_crc16 = esphome::crc16(data, 4 + length);
-
-  if (crc16 != calculated_crc16) {
-    ESP_LOGW(TAG, "Received invalid message checksum %02X!=%02X", crc16, calculated_crc16);
-    return false;
+void NSPanelLovelace::process_frame_result_(frame_result result, const uint8_t *data, size_t len) {
+  switch (result) {
+  case frame_result::incomplete:
+    break;
+  case frame_result::frame:
+    // commands queued in response to the panel are sent before background updates
+    this->interactive_ = true;
+    this->process_command_(std::string_view(reinterpret_cast<const char *>(data), len));
+    this->interactive_ = false;
+    break;
+  // todo: store 'tft_connected' state?
+  case frame_result::nextion_startup:
+    ESP_LOGD(TAG, "Nextion started");
+    this->sent_command_cache_.clear();
+    break;
+  case frame_result::nextion_ready:
+    ESP_LOGD(TAG, "Nextion ready");
+    break;
+  case frame_result::invalid:
+    ESP_LOGW(TAG, "Unparsed data: %s", esphome::format_hex(data, len).c_str());
+    break;
   }
-
-  const uint8_t *message_data = data + 4;
-  std::string message(message_data, message_data + length);
-
-  this->process_command_(message);
-  this->buffer_.clear();
-  return true;
 }
 
 #ifdef TEST_DEVICE_MODE
 void NSPanelLovelace::process_command(const std::string &message) {
+  this->interactive_ = true;
   this->process_command_(message);
+  this->interactive_ = false;
 };
 #endif
 
-void NSPanelLovelace::process_command_(const std::string &message) {
-  ESP_LOGD(TAG, "TFT CMD IN: %s", message.c_str());
+void NSPanelLovelace::process_command_(std::string_view message) {
+  ESP_LOGD(TAG, "TFT CMD IN: %.*s", static_cast<int>(message.size()), message.data());
 
-  std::vector<std::string> tokens;
-  tokens.reserve(5);
-  split_str(',', message, tokens);
-  if (tokens.size() < 2 || tokens.at(0) != "event") { return; }
+  // note: the tokens are views of the message so no memory is allocated here
+  std::array<std::string_view, 5> tokens;
+  auto token_count = split_str(',', message, tokens);
+  if (token_count < 2 || tokens[0] != "event") { return; }
 
   // note: from luibackend/mqtt.py
-  if (tokens.at(1) == action_type::buttonPress2) {
-    if (tokens.size() == 5) {
-      this->process_button_press_(tokens.at(2), tokens.at(3), tokens.at(4));
-    } else if (tokens.size() == 4) {
-      this->process_button_press_(tokens.at(2), tokens.at(3));
-    }
-  } else if (tokens.at(1) == action_type::pageOpenDetail) {
-    this->render_popup_page_(tokens.at(3));
-  } else if (tokens.at(1) == action_type::sleepReached) {
+  switch (to_event_action(tokens[1])) {
+  case event_action::buttonPress2:
+    // the display may have changed what is shown (e.g. a slider was moved)
+    this->sent_command_cache_.clear();
+    if (token_count == 5) {
+      this->process_button_press_(tokens[2], to_button_action(tokens[3]), tokens[4]);
+    } else if (token_count == 4) {
+      this->process_button_press_(tokens[2], to_button_action(tokens[3]));
+    }
+    break;
+  case event_action::pageOpenDetail:
+    if (token_count < 4) break;
+    // the popup is empty until its details are sent again, even when they haven't changed
+    this->sent_command_cache_.clear();
+    this->render_popup_page_(std::string(tokens[3]));
+    break;
+  case event_action::sleepReached:
     //std::string page = tokens.at(2);
 
     // todo: temporary, render default page instead
     this->render_page_(render_page_option::screensaver);
-  } else if (tokens.at(1) == action_type::startup) {
-    if (tokens.size() == 4) {
+    break;
+  case event_action::startup:
+    this->sent_command_cache_.clear();
+    if (token_count == 4) {
       uint16_t ver = 0;
-      if(std::sscanf(tokens.at(2).c_str(), "%" PRIu16, &ver) == 1) {
+      if(std::sscanf(std::string(tokens[2]).c_str(), "%" PRIu16, &ver) == 1) {
         Configuration::set_version(ver);
       }
-      Configuration::set_model(tokens.at(3));
+      Configuration::set_model(std::string(tokens[3]));
     }
     if (Configuration::get_model() == nspanel_model_t::unknown) {
       ESP_LOGW(TAG, "Unknown NSPanel model!");
@@ -552,6 +437,9 @@ void NSPanelLovelace::process_command_(const std::string &message) {
       this->update_datetime();
     }
 #endif
+    break;
+  default:
+    break;
   }
 
   this->incoming_msg_callback_.call(message);
@@ -789,7 +677,7 @@ void NSPanelLovelace::render_cover_detail_update_(StatefulPageItem *item) {
   bool tilt_position_status = false;
 
   if (cover_icons_found) {
-    if (entity->is_state(entity_state::closed)) {
+    if (entity->is_state(entity_state_t::closed)) {
       cover_icon = cover_icons.at(1);
     } else {
       cover_icon = cover_icons.at(0);
@@ -803,8 +691,8 @@ void NSPanelLovelace::render_cover_detail_update_(StatefulPageItem *item) {
   }
   // OPEN
   if (supported_features & 0b00000001) {
-    if (position != 100 && !((entity->is_state(entity_state::open) ||
-        entity->is_state(entity_state::unknown)) &&
+    if (position != 100 && !((entity->is_state(entity_state_t::open) ||
+        entity->is_state(entity_state_t::unknown)) &&
         position_str.empty())) {
       icon_up_status = true;
     }
@@ -813,8 +701,8 @@ void NSPanelLovelace::render_cover_detail_update_(StatefulPageItem *item) {
   }
   // CLOSE
   if (supported_features & 0b00000010) {
-    if (position != 0 && !((entity->is_state(entity_state::closed) ||
-        entity->is_state(entity_state::unknown)) &&
+    if (position != 0 && !((entity->is_state(entity_state_t::closed) ||
+        entity->is_state(entity_state_t::unknown)) &&
         position_str.empty())) {
       icon_down_status = true;
     }
@@ -823,7 +711,7 @@ void NSPanelLovelace::render_cover_detail_update_(StatefulPageItem *item) {
   }
   // STOP
   if (supported_features & 0b00001000) {
-    icon_stop_status = !entity->is_state(entity_state::unknown);
+    icon_stop_status = !entity->is_state(entity_state_t::unknown);
     icon_stop = icon_t::stop;
   }
 
@@ -919,17 +807,17 @@ void NSPanelLovelace::render_light_detail_update_(StatefulPageItem *item) {
   if (item == nullptr) return;
 
   auto entity = item->get_entity();
-  auto &supported_modes = entity->get_attribute(ha_attr_type::supported_color_modes);
-  bool enable_color_wheel = entity->is_state(entity_state::on) &&
-      (contains_value(supported_modes, ha_attr_color_mode::xy) || 
-      contains_value(supported_modes, ha_attr_color_mode::hs) ||
-      contains_value(supported_modes, ha_attr_color_mode::rgb) ||
-      contains_value(supported_modes, ha_attr_color_mode::rgbw) ||
-      contains_value(supported_modes, ha_attr_color_mode::rgbww));
+  auto supported_modes = entity->get_attribute_list(ha_attr_type::supported_color_modes);
+  bool enable_color_wheel = entity->is_state(entity_state_t::on) &&
+      (supported_modes.contains(ha_attr_color_mode::xy) || 
+      supported_modes.contains(ha_attr_color_mode::hs) ||
+      supported_modes.contains(ha_attr_color_mode::rgb) ||
+      supported_modes.contains(ha_attr_color_mode::rgbw) ||
+      supported_modes.contains(ha_attr_color_mode::rgbww));
 
   std::string color_mode = entity->get_attribute(ha_attr_type::color_mode);
   std::string color_temp = generic_type::disable;
-  if (contains_value(supported_modes, ha_attr_color_mode::color_temp)) {
+  if (supported_modes.contains(ha_attr_color_mode::color_temp)) {
     if (color_mode == ha_attr_color_mode::color_temp) {
       color_temp = entity->get_attribute(ha_attr_type::color_temp, generic_type::disable);
     } else {
@@ -947,7 +835,7 @@ void NSPanelLovelace::render_light_detail_update_(StatefulPageItem *item) {
     // icon_color~
     .append(item->get_icon_color_str()).append(1, SEPARATOR)
     // switch_val~
-    .append(std::to_string(entity->is_state(entity_state::on) ? 1 : 0)).append(1, SEPARATOR)
+    .append(std::to_string(entity->is_state(entity_state_t::on) ? 1 : 0)).append(1, SEPARATOR)
     // brightness~ (0-100)
     .append(entity->get_attribute(ha_attr_type::brightness, generic_type::disable)).append(1, SEPARATOR)
     // color_temp~ (color temperature value or 'disable')
@@ -969,15 +857,14 @@ void NSPanelLovelace::render_light_detail_update_(StatefulPageItem *item) {
 void NSPanelLovelace::render_timer_detail_update_(StatefulPageItem *item) {
   if (item == nullptr) return;
 
-  auto &state = item->get_state();
   bool render = false;
   uint16_t min_remaining = 0, sec_remaining = 0;
-  bool idle = state == entity_state::paused || state == entity_state::idle;
+  bool idle = item->is_state(entity_state_t::paused) || item->is_state(entity_state_t::idle);
 
   if (idle) {
     this->cancel_interval(entity_type::timer);
     std::string time_remaining_str;
-    if (state == entity_state::paused) {
+    if (item->is_state(entity_state_t::paused)) {
       time_remaining_str = item->get_attribute(ha_attr_type::remaining);
     } else {
       time_remaining_str = item->get_attribute(ha_attr_type::duration);
@@ -1066,16 +953,16 @@ void NSPanelLovelace::render_climate_detail_update_(Entity *entity, const std::s
   if(entity == nullptr) return;
 
   uint16_t icon_colour = 64512U;
-  auto &state = entity->get_state();
-  if (state == entity_state::auto_ ||
-      state == entity_state::heat_cool) {
+  auto state = entity->get_state_id();
+  if (state == entity_state_t::auto_ ||
+      state == entity_state_t::heat_cool) {
     icon_colour = 1024U;
-  } else if (state == entity_state::off ||
-      state == entity_state::fan_only) {
+  } else if (state == entity_state_t::off ||
+      state == entity_state_t::fan_only) {
     icon_colour = 35921U;
-  } else if (state == entity_state::cool) {
+  } else if (state == entity_state_t::cool) {
     icon_colour = 11487U;
-  } else if (state == entity_state::dry) {
+  } else if (state == entity_state_t::dry) {
     icon_colour = 60897U;
   }
 
@@ -1103,25 +990,9 @@ void NSPanelLovelace::render_climate_detail_update_(Entity *entity, const std::s
   };
 
   for (auto mt : mode_types) {
-    auto &supported_modes = entity->get_attribute(mt);
+    auto supported_modes = entity->get_attribute_list(mt);
     if (supported_modes.empty()) continue;
-    
-    std::string mode_res;
-    if (mt == ha_attr_type::preset_modes) {
-      mode_res.reserve(supported_modes.size());
-      size_t pos_start = std::string::npos, pos_end = pos_start;
-      do {
-        pos_end = supported_modes.find(',', pos_start + 1);
-        mode_res.append(
-          get_translation(
-            supported_modes.substr(pos_start + 1, pos_end - pos_start - 1)));
-        if (pos_end != std::string::npos) mode_res.append(1, '?');
-        pos_start = pos_end;
-      } while (pos_start != std::string::npos);
-    } else {
-      mode_res = supported_modes;
-      replace_all(mode_res, ',', '?');
-    }
+
     std::string mode_type = to_string(mt);
     mode_type.pop_back();
 
@@ -1131,9 +1002,22 @@ void NSPanelLovelace::render_climate_detail_update_(Entity *entity, const std::s
       // mode~
       .append(to_string(mt)).append(1, SEPARATOR)
       // curr_mode~
-      .append(entity->get_attribute(to_ha_attr(mode_type))).append(1, SEPARATOR)
-      // mode_res~ (mode names separated by '?')
-      .append(mode_res).append(1, SEPARATOR);
+      .append(entity->get_attribute(to_ha_attr(mode_type))).append(1, SEPARATOR);
+    // mode_res~ (mode names separated by '?')
+    if (mt == ha_attr_type::preset_modes) {
+      for (size_t i = 0; i < supported_modes.size(); i++) {
+        if (i > 0) this->command_buffer_.append(1, '?');
+        const char *translation;
+        if (try_get_translation(supported_modes[i], translation)) {
+          this->command_buffer_.append(translation);
+        } else {
+          this->command_buffer_.append(supported_modes[i]);
+        }
+      }
+    } else {
+      supported_modes.append_to(this->command_buffer_, '?');
+    }
+    this->command_buffer_.append(1, SEPARATOR);
   }
 }
 
@@ -1141,20 +1025,20 @@ void NSPanelLovelace::render_climate_detail_update_(Entity *entity, const std::s
 void NSPanelLovelace::render_input_select_detail_update_(StatefulPageItem *item) {
   if(item == nullptr) return;
 
+  auto entity = item->get_entity();
   auto state = item->get_state();
-  std::string options;
+  StringListView options;
   if (item->is_type(entity_type::input_select) || 
       item->is_type(entity_type::select)) {
-    options = item->get_attribute(ha_attr_type::options);
+    options = entity->get_attribute_list(ha_attr_type::options);
   }
   else if (item->is_type(entity_type::light)) {
-    options = item->get_attribute(ha_attr_type::effect_list);
+    options = entity->get_attribute_list(ha_attr_type::effect_list);
   }
   else if (item->is_type(entity_type::media_player)) {
-    options = item->get_attribute(ha_attr_type::source_list);
-    state = item->get_attribute(ha_attr_type::source);
+    options = entity->get_attribute_list(ha_attr_type::source_list);
+    state = entity->get_attribute(ha_attr_type::source);
   }
-  if (!options.empty()) replace_all(options, ',', '?');
 
   this->command_buffer_
     // entityUpdateDetail2~
@@ -1166,9 +1050,9 @@ void NSPanelLovelace::render_input_select_detail_update_(StatefulPageItem *item)
     // ha_type~
     .append(item->get_type()).append(1, SEPARATOR)
     // state~
-    .append(state).append(1, SEPARATOR)
-    // options~
-    .append(options).append(1, SEPARATOR);
+    .append(state).append(1, SEPARATOR);
+  // options~ (separated by '?')
+  options.append_to(this->command_buffer_, '?').append(1, SEPARATOR);
 }
 
 // entityUpdateDetail~{entity_id}~~{icon_color}~{switch_val}~{speed}~{speed_max}~{speed_translation}~{preset_mode}~{preset_modes}
@@ -1176,20 +1060,15 @@ void NSPanelLovelace::render_fan_detail_update_(StatefulPageItem *item) {
   if(item == nullptr) return;
 
   auto speed = item->get_attribute(ha_attr_type::percentage);
-  auto percentage_step = item->get_attribute(ha_attr_type::percentage_step);
   auto preset_mode = item->get_attribute(ha_attr_type::preset_mode);
-  auto preset_modes = item->get_attribute(ha_attr_type::preset_modes);
-  if (!preset_modes.empty()) replace_all(preset_modes, ',', '?');
+  auto preset_modes = item->get_entity()->get_attribute_list(ha_attr_type::preset_modes);
 
+  const bool has_step = item->get_entity()->has_attribute(ha_attr_type::percentage_step);
   uint8_t speed_max = 100;
-  if (!percentage_step.empty()) {
-    float speed_val = 0.0f;
-    if (speed.empty()) {
-      speed = "0";
-    } else {
-      speed_val = std::stof(speed);
-    }
-    auto step_val = std::stof(percentage_step);
+  if (has_step) {
+    float speed_val = item->get_attribute_number(ha_attr_type::percentage);
+    if (speed.empty()) speed = "0";
+    auto step_val = item->get_attribute_number(ha_attr_type::percentage_step);
     if (step_val < 1.0f) step_val = 1.0f; // avoid divide-by-zero
     speed = esphome::to_string(
       static_cast<uint16_t>(round(speed_val / step_val)));
@@ -1204,19 +1083,19 @@ void NSPanelLovelace::render_fan_detail_update_(StatefulPageItem *item) {
     // icon_color~
     .append(item->get_icon_color_str()).append(1, SEPARATOR)
     // switch_val~
-    .append(esphome::to_string(item->is_state(entity_state::on) ? 1 : 0))
+    .append(esphome::to_string(item->is_state(entity_state_t::on) ? 1 : 0))
     .append(1, SEPARATOR)
     // speed~
-    .append(percentage_step.empty() ? generic_type::disable : speed)
+    .append(has_step ? speed : generic_type::disable)
     .append(1, SEPARATOR)
     // speed_max~
     .append(esphome::to_string(speed_max)).append(1, SEPARATOR)
     // speed_translation~
     .append(get_translation(translation_item::speed)).append(1, SEPARATOR)
     // preset_mode~
-    .append(preset_mode).append(1, SEPARATOR)
-    // preset_modes
-    .append(preset_modes);
+    .append(preset_mode).append(1, SEPARATOR);
+  // preset_modes (separated by '?')
+  preset_modes.append_to(this->command_buffer_, '?');
 }
 
 void NSPanelLovelace::dump_config() {
@@ -1232,13 +1111,54 @@ void NSPanelLovelace::dump_config() {
       this->pages_.size(),
       this->stateful_page_items_.size(),
       this->entities_.size());
+  ESP_LOGCONFIG(TAG, "\tWorker: running:%s,completed:%" PRIu32 ",max_pending:%zu",
+      YESNO(this->worker_.is_running()),
+      this->worker_.get_completed_count(),
+      this->worker_.get_max_pending());
+  ESP_LOGCONFIG(TAG, "\tAttribute notifications: dispatched:%" PRIu32 ",skipped:%" PRIu32 ",duplicates_dropped:%" PRIu32,
+      Entity::get_dispatched_attribute_notifications(),
+      Entity::get_skipped_attribute_notifications(),
+      Entity::get_duplicate_attribute_updates());
+  for (auto lane : {command_lane::interactive, command_lane::background}) {
+    const auto &queue = this->command_scheduler_.get_queue(lane);
+    const auto &stats = this->command_scheduler_.get_stats(lane);
+    ESP_LOGCONFIG(TAG, "\tCommand queue (%s): size:%zu,high_water_mark:%zu,dropped:%" PRIu32 ",coalesced:%" PRIu32,
+        to_string(lane),
+        queue.get_capacity(),
+        queue.get_high_water_mark(),
+        queue.get_dropped_count(),
+        queue.get_coalesced_count());
+    ESP_LOGCONFIG(TAG, "\tCommand delay (%s): sent:%" PRIu32 ",avg_ms:%" PRIu32 ",max_ms:%" PRIu32,
+        to_string(lane),
+        stats.sent,
+        stats.sent == 0 ? 0 : stats.total_delay_ms / stats.sent,
+        stats.max_delay_ms);
+  }
+  ESP_LOGCONFIG(TAG, "\tUnchanged commands skipped: %" PRIu32 " (%" PRIu32 " bytes)",
+      this->sent_command_cache_.get_suppressed_count(),
+      this->sent_command_cache_.get_suppressed_bytes());
+  if (this->uart_receiver_ != nullptr) {
+    const auto &stats = this->uart_receiver_->get_stats();
+    ESP_LOGCONFIG(TAG, "\tUART task: received:%" PRIu32 ",avg_latency_ms:%" PRIu32 ",max_latency_ms:%" PRIu32
+        ",dropped:%" PRIu32 ",overflows:%" PRIu32,
+        stats.received,
+        stats.received == 0 ? 0 : stats.total_latency_ms / stats.received,
+        stats.max_latency_ms,
+        this->uart_receiver_->get_dropped_count(),
+        this->uart_receiver_->get_overflow_count());
+  } else {
+    ESP_LOGCONFIG(TAG, "\tUART: resyncs:%" PRIu32 ",recovered_frames:%" PRIu32,
+        this->frame_parser_.get_resync_count(),
+        this->frame_parser_.get_recovered_count());
+  }
 }
 
 void NSPanelLovelace::send_nextion_command_(const std::string &command) {
   ESP_LOGD(TAG, "Sending: %s", command.c_str());
-  this->write_str(command.c_str());
-  const uint8_t to_send[3] = {0xFF, 0xFF, 0xFF};
-  this->write_array(to_send, sizeof(to_send));
+  auto &buffer = this->tx_buffer_;
+  buffer.assign(command.begin(), command.end());
+  buffer.insert(buffer.end(), {0xFF, 0xFF, 0xFF});
+  this->write_array(buffer.data(), buffer.size());
 }
 
 void NSPanelLovelace::process_display_command_queue_() {
@@ -1247,46 +1167,47 @@ void NSPanelLovelace::process_display_command_queue_() {
   if (this->is_updating_) return;
 #endif
   // nothing to process
-  if (this->command_buffer_.empty() && this->command_queue_.empty()) return;
-
-  // Store the command for later processing so the function can return quickly
-  if (!this->command_buffer_.empty()) {
-    this->command_queue_.push(this->command_buffer_);
-    ESP_LOGVV(TAG, "Command queued (size: %u)", this->command_queue_.size());
-    this->command_buffer_.clear();
+  if (this->command_scheduler_.empty()) return;
+
+  // note: the command is sent straight from the queue's buffer,
+  //       the scheduler picks the lane to send from
+  auto command = this->command_scheduler_.front();
+  auto key = get_command_key(command);
+  if (this->sent_command_cache_.is_duplicate(key, command)) {
+    ESP_LOGV(TAG, "TFT CMD OUT skipped (unchanged): %s", to_string(key.kind));
+    this->command_scheduler_.pop();
     return;
-  } else if (!this->command_queue_.empty()) {
-    // todo: can we use std::move? it changes the capacity of the buffer
-    this->command_buffer_.assign(this->command_queue_.front());
-    this->command_queue_.pop();
-    ESP_LOGVV(TAG, "Command un-queued (size: %u)", this->command_queue_.size());
-  }
-
-  ESP_LOGD(TAG, "TFT CMD OUT: %s", this->command_buffer_.c_str());
-  std::array<uint8_t, 4> crc_data = {
-    0x55, 0xBB, 
-    static_cast<uint8_t>(command_buffer_.length() & 0xFF),
-    static_cast<uint8_t>((command_buffer_.length() >> 8) & 0xFF)
-  };
-  auto crc = esphome::crc16(crc_data.data(), 4);
-  crc = esphome::crc16(
-    reinterpret_cast<const uint8_t *>(command_buffer_.c_str()),
-    command_buffer_.length(), crc);
+  }
+  ESP_LOGD(TAG, "TFT CMD OUT: %.*s", static_cast<int>(command.size()), command.data());
+
+  // The whole frame is assembled first so it is written to the UART in one go
+  auto &buffer = this->tx_buffer_;
+  buffer.clear();
+  buffer.insert(buffer.end(), {
+    FRAME_HEADER1, FRAME_HEADER2,
+    static_cast<uint8_t>(command.length() & 0xFF),
+    static_cast<uint8_t>((command.length() >> 8) & 0xFF)
+  });
+  buffer.insert(buffer.end(), command.begin(), command.end());
+  auto crc = Crc16::calculate(buffer.data(), buffer.size());
+  buffer.push_back(static_cast<uint8_t>(crc & 0xFF));
+  buffer.push_back(static_cast<uint8_t>((crc >> 8) & 0xFF));
 
-  this->write_array(crc_data);
   App.feed_wdt();
-  this->write_str(this->command_buffer_.c_str());
-  crc_data[0] = static_cast<uint8_t>(crc & 0xFF);
-  crc_data[1] = static_cast<uint8_t>((crc >> 8) & 0xFF);
-  this->write_array(crc_data.data(), 2);
-  
-  this->command_buffer_.clear();
+  this->write_array(buffer.data(), buffer.size());
+
   this->command_last_sent_ = millis();
+  this->sent_command_cache_.update(key, command);
+  this->command_scheduler_.pop();
+  ESP_LOGVV(TAG, "Command un-queued (size: %zu)", this->command_scheduler_.size());
 }
 
 void NSPanelLovelace::send_buffered_command_() {
   if (this->command_buffer_.empty()) return;
-  this->process_display_command_queue_();
+  // Store the command for later processing so the function can return quickly
+  this->command_scheduler_.push(this->command_buffer_, this->interactive_);
+  ESP_LOGVV(TAG, "Command queued (size: %zu)", this->command_scheduler_.size());
+  this->command_buffer_.clear();
 }
 
 void NSPanelLovelace::notify_on_screensaver(
@@ -1635,64 +1556,72 @@ const std::string &NSPanelLovelace::try_replace_uuid_with_entity_id_(
 }
 
 void NSPanelLovelace::process_button_press_(
-    std::string &internal_id, 
-    const std::string &button_type, 
-    const std::string &value,
-    bool called_from_timeout) {
-  if (button_type.empty()) return;
+    std::string_view internal_id, button_action action, std::string_view value) {
+  if (action == button_action::unknown) return;
   
   // Throttle and filter processing of spammy actions to avoid command flooding
-  if (!called_from_timeout) {
-    if (internal_id == this->button_press_uuid_ && 
-        button_type == this->button_press_type_) {
-      this->button_press_value_ = value;
-      if (this->button_press_timeout_set_) return;
-      this->set_timeout("btnpr", 200, [this]() {
-        this->button_press_timeout_set_ = false;
-        ESP_LOGD(TAG, "Button press delayed: %s,%s,%s", 
-            this->button_press_uuid_.c_str(), this->button_press_type_.c_str(), 
-            this->button_press_value_.c_str());
-        this->process_button_press_(
-            this->button_press_uuid_, this->button_press_type_, 
-            this->button_press_value_, true);
-      });
-      this->button_press_timeout_set_ = true;
-      return;
-    } else if (this->button_press_timeout_set_) {
-      this->cancel_timeout("btnpr");
+  if (internal_id == this->button_press_uuid_ && 
+      action == this->button_press_action_) {
+    this->button_press_value_.assign(value.data(), value.size());
+    if (this->button_press_timeout_set_) return;
+    this->set_timeout("btnpr", 200, [this]() {
       this->button_press_timeout_set_ = false;
-    }
-    this->button_press_uuid_ = internal_id;
-    this->button_press_type_ = button_type;
-  }
+      ESP_LOGD(TAG, "Button press delayed: %s,%s,%s", 
+          this->button_press_uuid_.c_str(), to_string(this->button_press_action_), 
+          this->button_press_value_.c_str());
+      this->interactive_ = true;
+      this->execute_button_press_();
+      this->interactive_ = false;
+    });
+    this->button_press_timeout_set_ = true;
+    return;
+  } else if (this->button_press_timeout_set_) {
+    this->cancel_timeout("btnpr");
+    this->button_press_timeout_set_ = false;
+  }
+  // note: assigning reuses the existing string capacity
+  this->button_press_uuid_.assign(internal_id.data(), internal_id.size());
+  this->button_press_action_ = action;
+  this->button_press_value_.assign(value.data(), value.size());
+  this->execute_button_press_();
+}
+
+void NSPanelLovelace::execute_button_press_() {
+  const std::string &internal_id = this->button_press_uuid_;
+  const std::string &value = this->button_press_value_;
+  const auto action = this->button_press_action_;
 
   auto entity_type = get_entity_type(internal_id);
-  std::string& entity_id = internal_id;
+  const std::string *entity_id_ptr = &internal_id;
   
   if (entity_type == entity_type::uuid) {
-    entity_id = this->try_replace_uuid_with_entity_id_(internal_id);
-    ESP_LOGV(TAG, "Lookup %s -> %s", internal_id.c_str(), entity_id.c_str());
-    entity_type = get_entity_type(entity_id);
+    entity_id_ptr = &this->try_replace_uuid_with_entity_id_(internal_id);
+    ESP_LOGV(TAG, "Lookup %s -> %s", internal_id.c_str(), entity_id_ptr->c_str());
+    entity_type = get_entity_type(*entity_id_ptr);
     if (entity_type == nullptr) return;
   }
+  const std::string &entity_id = *entity_id_ptr;
 
-  // Screen tapped when on the screensaver, show the default card or use the first card in the config.
-  if (internal_id == to_string(page_type::screensaver) && button_type == button_type::bExit) {
-    // todo: make a note of last used card
-    //
-    // config.get("screensaver.defaultCard")
-    // use defaultCard if defaultCard not null
+  switch (action) {
+  case button_action::bExit:
+    // Screen tapped when on the screensaver, show the default card or use the first card in the config.
+    if (internal_id == to_string(page_type::screensaver)) {
+      // todo: make a note of last used card
+      //
+      // config.get("screensaver.defaultCard")
+      // use defaultCard if defaultCard not null
 
-    // _previous_card.clear();
-    // _current_card = action_type::screensaver;
-    // render_card(_current_card);
+      // _previous_card.clear();
+      // _current_card = action_type::screensaver;
+      // render_card(_current_card);
 
-    // todo: temporary for testing
-    this->render_page_(render_page_option::default_page);
+      // todo: temporary for testing
+      this->render_page_(render_page_option::default_page);
+      return;
+    }
+    this->render_current_page_();
     return;
-  }
-
-  if (button_type == button_type::sleepReached) {
+  case button_action::sleepReached:
     // todo
     // make a note of last used card then render screensaver
     // _previous_card = _current_card;
@@ -1700,23 +1629,17 @@ void NSPanelLovelace::process_button_press_(
     // render_page_(_current_card);
     this->render_page_(render_page_option::screensaver);
     return;
-  }
-
-  if (button_type == button_type::bExit) {
-    this->render_current_page_();
-    return;
-  }
-
-  if (button_type == button_type::onOff) {
+  case button_action::onOff: {
     if (!value.empty()) {
       this->call_ha_service_(
         entity_type, 
         value == "1" ? ha_action_type::turn_on : ha_action_type::turn_off, 
         entity_id);
     }
-  } 
+    break;
+  }
   // fan, number, input_number
-  else if (button_type == button_type::numberSet) {
+  case button_action::numberSet: {
     if (entity_type == entity_type::fan) {
       auto entity = this->get_entity_(entity_id);
       if (entity == nullptr) return;
@@ -1743,18 +1666,25 @@ void NSPanelLovelace::process_button_press_(
           {to_string(ha_attr_type::value), value}
         }});
     }
+    break;
   }
   // cover and shutter cards
-  else if (button_type == button_type::up) {
+  case button_action::up: {
     this->call_ha_service_(
       entity_type, ha_action_type::open_cover, entity_id);
-  } else if (button_type == button_type::stop) {
+    break;
+  }
+  case button_action::stop: {
     this->call_ha_service_(
       entity_type, ha_action_type::stop_cover, entity_id);
-  } else if (button_type == button_type::down) {
+    break;
+  }
+  case button_action::down: {
     this->call_ha_service_(
       entity_type, ha_action_type::close_cover, entity_id);
-  } else if (button_type == button_type::positionSlider) {
+    break;
+  }
+  case button_action::positionSlider: {
     this->call_ha_service_(
       entity_type, 
       ha_action_type::set_cover_position, 
@@ -1762,16 +1692,24 @@ void NSPanelLovelace::process_button_press_(
         {to_string(ha_attr_type::entity_id), entity_id},
         {to_string(ha_attr_type::position), value}
       }});
-  } else if (button_type == button_type::tiltOpen) {
+    break;
+  }
+  case button_action::tiltOpen: {
     this->call_ha_service_(
       entity_type, ha_action_type::open_cover_tilt, entity_id);
-  } else if (button_type == button_type::tiltStop) {
+    break;
+  }
+  case button_action::tiltStop: {
     this->call_ha_service_(
       entity_type, ha_action_type::stop_cover_tilt, entity_id);
-  } else if (button_type == button_type::tiltClose) {
+    break;
+  }
+  case button_action::tiltClose: {
     this->call_ha_service_(
       entity_type, ha_action_type::close_cover_tilt, entity_id);
-  } else if (button_type == button_type::tiltSlider) {
+    break;
+  }
+  case button_action::tiltSlider: {
     this->call_ha_service_(
       entity_type, 
       ha_action_type::set_cover_tilt_position, 
@@ -1779,7 +1717,9 @@ void NSPanelLovelace::process_button_press_(
         {to_string(ha_attr_type::entity_id), entity_id},
         {to_string(ha_attr_type::tilt_position), value}
       }});
-  } else if (button_type == button_type::button) {
+    break;
+  }
+  case button_action::button: {
     if (entity_type == entity_type::navigate ||
         entity_type == entity_type::navigate_uuid) {
       auto uuid = internal_id.substr(strlen(entity_type) + 1);
@@ -1809,7 +1749,7 @@ void NSPanelLovelace::process_button_press_(
       auto entity = this->get_entity_(entity_id);
       if (entity == nullptr) return;
       this->call_ha_service_(entity_type,
-        entity->is_state(entity_state::docked) 
+        entity->is_state(entity_state_t::docked) 
           ? ha_action_type::start 
           : ha_action_type::return_to_base,
         entity_id);
@@ -1817,32 +1757,41 @@ void NSPanelLovelace::process_button_press_(
       auto entity = this->get_entity_(entity_id);
       if (entity == nullptr) return;
       this->call_ha_service_(entity_type,
-        entity->is_state(entity_state::locked) 
+        entity->is_state(entity_state_t::locked) 
           ? ha_action_type::unlock 
           : ha_action_type::lock,
         entity_id);
     }
+    break;
   }
   // media cards
-  else if (button_type == button_type::mediaNext) {
+  case button_action::mediaNext: {
     this->call_ha_service_(
       entity_type, ha_action_type::media_next_track, entity_id);
-  } else if (button_type == button_type::mediaBack) {
+    break;
+  }
+  case button_action::mediaBack: {
     this->call_ha_service_(
       entity_type, ha_action_type::media_previous_track, entity_id);
-  } else if (button_type == button_type::mediaPause) {
+    break;
+  }
+  case button_action::mediaPause: {
     this->call_ha_service_(
       entity_type, ha_action_type::media_play_pause, entity_id);
-  } else if (button_type == button_type::mediaOnOff) {
+    break;
+  }
+  case button_action::mediaOnOff: {
     auto entity = this->get_entity_(entity_id);
     if (entity == nullptr) return;
     this->call_ha_service_(
       entity_type,
-      entity->is_state(entity_state::on) 
+      entity->is_state(entity_state_t::on) 
         ? ha_action_type::turn_off 
         : ha_action_type::turn_on,
       entity_id);
-  } else if (button_type == button_type::mediaShuffle) {
+    break;
+  }
+  case button_action::mediaShuffle: {
     auto entity = this->get_entity_(entity_id);
     if (entity == nullptr) return;
     auto shuffle = entity->get_attribute(ha_attr_type::shuffle);
@@ -1856,7 +1805,9 @@ void NSPanelLovelace::process_button_press_(
         {to_string(ha_attr_type::entity_id), entity_id},
         {to_string(ha_attr_type::shuffle), shuffle}
       }});
-  } else if (button_type == button_type::volumeSlider) {
+    break;
+  }
+  case button_action::volumeSlider: {
     auto volume = esphome::str_snprintf("%.2f", 7, std::stoi(value) * 0.01f);
     this->call_ha_service_(
       entity_type,
@@ -1865,7 +1816,9 @@ void NSPanelLovelace::process_button_press_(
         {to_string(ha_attr_type::entity_id), entity_id},
         {to_string(ha_attr_type::volume_level), volume}
       }});
-  } else if (button_type == button_type::speakerSel) {
+    break;
+  }
+  case button_action::speakerSel: {
     this->call_ha_service_(
       entity_type,
       ha_action_type::select_source,
@@ -1873,13 +1826,13 @@ void NSPanelLovelace::process_button_press_(
         {to_string(ha_attr_type::entity_id), entity_id},
         {to_string(ha_attr_type::source), value}
       }});
-  } else if (button_type == button_type::modeMediaPlayer) {
+    break;
+  }
+  case button_action::modeMediaPlayer: {
     auto entity = this->get_entity_(entity_id);
     if (entity == nullptr) return;
-    auto source_list_str = entity->get_attribute(ha_attr_type::source_list);
-    if (source_list_str.empty()) return;
-    std::vector<std::string> source_list;
-    split_str(',', source_list_str, source_list);
+    auto source_list = entity->get_attribute_list(ha_attr_type::source_list);
+    if (source_list.empty()) return;
     uint8_t index = stoi(value);
     if (source_list.size() <= index) return;
     this->call_ha_service_(
@@ -1887,11 +1840,12 @@ void NSPanelLovelace::process_button_press_(
       ha_action_type::select_source,
       {{
         {to_string(ha_attr_type::entity_id), entity_id},
-        {to_string(ha_attr_type::source), source_list.at(index)}
+        {to_string(ha_attr_type::source), std::string(source_list[index])}
       }});
+    break;
   }
   // light cards
-  else if (button_type == button_type::brightnessSlider) {
+  case button_action::brightnessSlider: {
     if (value.empty()) return;
     this->call_ha_service_(
       entity_type, 
@@ -1904,14 +1858,14 @@ void NSPanelLovelace::process_button_press_(
             scale_value(std::stoi(value), {0, 100}, {0, 255})
           ))}
       }});
-  } else if (button_type == button_type::colorTempSlider) {
+    break;
+  }
+  case button_action::colorTempSlider: {
     if (value.empty()) return;
     auto entity = this->get_entity_(entity_id);
     if (entity == nullptr) return;
-    auto &minstr = entity->get_attribute(ha_attr_type::min_mireds);
-    auto &maxstr = entity->get_attribute(ha_attr_type::max_mireds);
-    uint16_t min_mireds = minstr.empty() ? 153 : std::stoi(minstr);
-    uint16_t max_mireds = maxstr.empty() ? 500 : std::stoi(maxstr);
+    uint16_t min_mireds = entity->get_attribute_number(ha_attr_type::min_mireds, 153);
+    uint16_t max_mireds = entity->get_attribute_number(ha_attr_type::max_mireds, 500);
     if (min_mireds >= max_mireds) {
       ESP_LOGW(TAG, "min/max mired range invalid %i>=%i", min_mireds, max_mireds);
       min_mireds = 153;
@@ -1930,7 +1884,9 @@ void NSPanelLovelace::process_button_press_(
             {static_cast<double>(min_mireds), static_cast<double>(max_mireds)})
           ))}
       }});
-  } else if (button_type == button_type::colorWheel) {
+    break;
+  }
+  case button_action::colorWheel: {
     if (value.empty()) return;
 
     std::vector<std::string> xy_tokens;
@@ -1953,9 +1909,10 @@ void NSPanelLovelace::process_button_press_(
       {{
         {to_string(ha_attr_type::rgb_color), rgb_str}
       }});
+    break;
   }
   // thermo/climate card
-  else if (button_type == button_type::tempUpd) {
+  case button_action::tempUpd: {
     auto val = esphome::str_snprintf("%.1f", 6, std::stoi(value) * 0.1);
     this->call_ha_service_(
       entity_type, 
@@ -1964,7 +1921,9 @@ void NSPanelLovelace::process_button_press_(
         {to_string(ha_attr_type::entity_id), entity_id},
         {to_string(ha_attr_type::temperature), val}
       }});
-  } else if (button_type == button_type::tempUpdHighLow) {
+    break;
+  }
+  case button_action::tempUpdHighLow: {
     std::vector<std::string> temp_values;
     split_str('|', value, temp_values);
     auto temp_high = esphome::str_snprintf(
@@ -1979,7 +1938,9 @@ void NSPanelLovelace::process_button_press_(
         {to_string(ha_attr_type::target_temp_high), temp_high},
         {to_string(ha_attr_type::target_temp_low), temp_low}
       }});
-  } else if (button_type == button_type::hvacAction) {
+    break;
+  }
+  case button_action::hvacAction: {
     this->call_ha_service_(
       entity_type, 
       ha_action_type::set_hvac_mode, 
@@ -1987,71 +1948,73 @@ void NSPanelLovelace::process_button_press_(
         {to_string(ha_attr_type::entity_id), entity_id},
         {to_string(ha_attr_type::hvac_mode), value}
       }});
-  } else if (button_type == button_type::modePresetModes) {
+    break;
+  }
+  case button_action::modePresetModes: {
     auto entity = this->get_entity_(entity_id);
     if (entity == nullptr) return;
-    auto &modes_str = entity->get_attribute(ha_attr_type::preset_modes);
-    if (modes_str.empty()) return;
-    std::vector<std::string> modes;
-    split_str(',', modes_str, modes);
-    auto &selected_mode = modes.at(std::stoi(value));
+    auto modes = entity->get_attribute_list(ha_attr_type::preset_modes);
+    uint8_t index = std::stoi(value);
+    if (modes.size() <= index) return;
     this->call_ha_service_(
       entity_type, 
       ha_action_type::set_preset_mode, 
       {{
         {to_string(ha_attr_type::entity_id), entity_id},
-        {to_string(ha_attr_type::preset_mode), selected_mode}
+        {to_string(ha_attr_type::preset_mode), std::string(modes[index])}
       }});
-  } else if (button_type == button_type::modeSwingModes) {
+    break;
+  }
+  case button_action::modeSwingModes: {
     auto entity = this->get_entity_(entity_id);
     if (entity == nullptr) return;
-    auto &modes_str = entity->get_attribute(ha_attr_type::swing_modes);
-    if (modes_str.empty()) return;
-    std::vector<std::string> modes;
-    split_str(',', modes_str, modes);
-    auto &selected_mode = modes.at(std::stoi(value));
+    auto modes = entity->get_attribute_list(ha_attr_type::swing_modes);
+    uint8_t index = std::stoi(value);
+    if (modes.size() <= index) return;
     this->call_ha_service_(
       entity_type, 
       ha_action_type::set_swing_mode, 
       {{
         {to_string(ha_attr_type::entity_id), entity_id},
-        {to_string(ha_attr_type::swing_mode), selected_mode}
+        {to_string(ha_attr_type::swing_mode), std::string(modes[index])}
       }});
-  } else if (button_type == button_type::modeFanModes) {
+    break;
+  }
+  case button_action::modeFanModes: {
     auto entity = this->get_entity_(entity_id);
     if (entity == nullptr) return;
-    auto &modes_str = entity->get_attribute(ha_attr_type::fan_modes);
-    if (modes_str.empty()) return;
-    std::vector<std::string> modes;
-    split_str(',', modes_str, modes);
-    auto &selected_mode = modes.at(std::stoi(value));
+    auto modes = entity->get_attribute_list(ha_attr_type::fan_modes);
+    uint8_t index = std::stoi(value);
+    if (modes.size() <= index) return;
     this->call_ha_service_(
       entity_type, 
       ha_action_type::set_fan_mode, 
       {{
         {to_string(ha_attr_type::entity_id), entity_id},
-        {to_string(ha_attr_type::fan_mode), selected_mode}
+        {to_string(ha_attr_type::fan_mode), std::string(modes[index])}
       }});
+    break;
   }
   // alarm card
-  else if (
-      button_type == button_type::armHome ||
-      button_type == button_type::armAway ||
-      button_type == button_type::armNight ||
-      button_type == button_type::armVacation ||
-      button_type == button_type::disarm) {
-    auto action = std::string("alarm_").append(button_type);
+  case button_action::armHome:
+  case button_action::armAway:
+  case button_action::armNight:
+  case button_action::armVacation:
+  case button_action::disarm: {
+    auto service = std::string("alarm_").append(to_string(action));
     if (value.empty()) {
-      this->call_ha_service_(entity_type, action.c_str(), entity_id);
+      this->call_ha_service_(entity_type, service, entity_id);
     } else {
       this->call_ha_service_(
-        entity_type, action.c_str(), 
+        entity_type, service, 
         {{
           {to_string(ha_attr_type::entity_id), entity_id},
           {to_string(ha_attr_type::code), value}
         }});
     }
-  } else if (button_type == button_type::opnSensorNotify) {
+    break;
+  }
+  case button_action::opnSensorNotify: {
     auto entity = this->get_entity_(entity_id);
     if (entity == nullptr) return;
     auto &open_sensors_str = entity->get_attribute(ha_attr_type::open_sensors);
@@ -2065,22 +2028,20 @@ void NSPanelLovelace::process_button_press_(
       message.append("- ").append(sensor).append("\r\n");
     }
     this->render_popup_notify_page_("", "", message);
+    break;
   }
   // unlock card
-  else if (button_type == button_type::cardUnlockUnlock) {
+  case button_action::cardUnlockUnlock: {
     if (!this->current_page_->is_type(page_type::cardUnlock)) return;
     // todo
+    break;
   }
   // select & input_select
-  else if (
-      button_type == button_type::modeInputSelect ||
-      button_type == button_type::modeSelect) {
+  case button_action::modeInputSelect:
+  case button_action::modeSelect: {
     auto entity = this->get_entity_(entity_id);
     if (entity == nullptr) return;
-    auto options_str = entity->get_attribute(ha_attr_type::options);
-    if (options_str.empty()) return;
-    std::vector<std::string> options;
-    split_str(',', options_str, options);
+    auto options = entity->get_attribute_list(ha_attr_type::options);
     uint8_t index = stoi(value);
     if (options.size() <= index) return;
     this->call_ha_service_(
@@ -2088,17 +2049,15 @@ void NSPanelLovelace::process_button_press_(
       ha_action_type::select_option,
       {{
         {to_string(ha_attr_type::entity_id), entity_id},
-        {to_string(ha_attr_type::option), options.at(index)}
+        {to_string(ha_attr_type::option), std::string(options[index])}
       }});
+    break;
   }
   // light
-  else if (button_type == button_type::modeLight) {
+  case button_action::modeLight: {
     auto entity = this->get_entity_(entity_id);
     if (entity == nullptr) return;
-    auto effects_str = entity->get_attribute(ha_attr_type::effect_list);
-    if (effects_str.empty()) return;
-    std::vector<std::string> effects;
-    split_str(',', effects_str, effects);
+    auto effects = entity->get_attribute_list(ha_attr_type::effect_list);
     uint8_t index = stoi(value);
     if (effects.size() <= index) return;
     this->call_ha_service_(
@@ -2106,12 +2065,16 @@ void NSPanelLovelace::process_button_press_(
       ha_action_type::turn_on,
       {{
         {to_string(ha_attr_type::entity_id), entity_id},
-        {to_string(ha_attr_type::effect), effects.at(index)}
+        {to_string(ha_attr_type::effect), std::string(effects[index])}
       }});
+    break;
   }
   // timer card
-  else if (esphome::str_startswith(button_type, entity_type::timer)) {
-    std::string service(button_type);
+  case button_action::timerStart:
+  case button_action::timerCancel:
+  case button_action::timerPause:
+  case button_action::timerFinish: {
+    std::string service(to_string(action));
     service[5] = '.';
     if (value.empty()) {
       this->call_ha_service_(service, entity_id);
@@ -2122,33 +2085,19 @@ void NSPanelLovelace::process_button_press_(
           {to_string(ha_attr_type::duration), value}
         }});
     }
+    break;
+  }
+  default:
+    break;
   }
 }
 
 StatefulPageItem* NSPanelLovelace::get_page_item_(const std::string &uuid) {
-  // use cached version if possible
-  if (this->cached_page_item_ != nullptr && 
-      this->cached_page_item_->get_uuid() == uuid) 
-    return this->cached_page_item_;
-
-  for (auto& item : this->stateful_page_items_) {
-    if (item->get_uuid() != uuid) continue;
-    return this->cached_page_item_ = item.get();
-  }
-  return this->cached_page_item_ = nullptr;
+  return this->page_item_index_.find(uuid);
 }
 
 Entity* NSPanelLovelace::get_entity_(const std::string &entity_id) {
-  // use cached version if possible
-  if (this->cached_entity_ != nullptr && 
-      this->cached_entity_->get_entity_id() == entity_id) 
-    return this->cached_entity_;
-
-  for (auto& entity : this->entities_) {
-    if (entity->get_entity_id() != entity_id) continue;
-    return this->cached_entity_ = entity.get();
-  }
-  return this->cached_entity_ = nullptr;
+  return this->entity_index_.find(entity_id);
 }
 
 void NSPanelLovelace::call_ha_service_(
@@ -2199,23 +2148,67 @@ void NSPanelLovelace::call_ha_service_(
   api::global_api_server->send_homeassistant_service_call(resp);
 }
 
-void NSPanelLovelace::on_entity_state_update_(std::string entity_id, std::string state) {
-  this->on_entity_attribute_update_(entity_id, to_string(ha_attr_type::state), state);
+bool NSPanelLovelace::subscribe_entity_(size_t entity_index, ha_attr_type attr) {
+  if (entity_index >= HA_SUBSCRIPTION_MAX_ENTITIES) {
+    ESP_LOGE(TAG, "Too many entities, '%s' will not be updated",
+      this->entities_[entity_index]->get_entity_id().c_str());
+    return false;
+  }
+  // note: The closure only holds 'this' and the handle so it is stored inside the
+  //       std::function, there are no copies of the entity_id or attribute to allocate.
+  const uint16_t handle = static_cast<uint16_t>(
+    (entity_index << HA_SUBSCRIPTION_ATTR_BITS) | static_cast<uint8_t>(attr));
+  api::global_api_server->subscribe_home_assistant_state(
+    this->entities_[entity_index]->get_entity_id(),
+    optional<std::string>(attr == ha_attr_type::state ? "" : to_string(attr)),
+    [this, handle](std::string value) { this->on_entity_update_(handle, std::move(value)); });
+  return true;
 }
-void NSPanelLovelace::on_entity_attribute_update_(std::string entity_id, std::string attr, std::string attr_value) {
-  auto entity = this->get_entity_(entity_id);
-  if (entity == nullptr) return;
-  auto ha_attr = to_ha_attr(attr);
-  if (ha_attr == ha_attr_type::unknown) return;
 
+void NSPanelLovelace::on_entity_update_(uint16_t handle, std::string value) {
+  const size_t index = handle >> HA_SUBSCRIPTION_ATTR_BITS;
+  if (index >= this->entities_.size()) return;
+  Entity *entity = this->entities_[index].get();
+  const auto ha_attr = static_cast<ha_attr_type>(
+    handle & ((1u << HA_SUBSCRIPTION_ATTR_BITS) - 1u));
+
+  // HA sends every value again when it reconnects, unchanged values must not
+  // schedule an update of the current page
+  bool changed;
   if (ha_attr == ha_attr_type::state) {
-    entity->set_state(attr_value);
+    changed = entity->set_state(std::move(value));
+  } else if (Entity::is_list_attribute(ha_attr) && this->worker_.is_running()) {
+    // HA sends every attribute again when it reconnects, so the value is compared
+    // with the last one submitted (not the stored one) before parsing it
+    if (!entity->record_list_update(ha_attr, value)) return;
+    // Lists are parsed by the worker and stored when they are ready.
+    // note: empty values are passed through the worker too so the
+    //       updates of an attribute are always stored in order
+    struct list_update {
+      Entity *entity;
+      ha_attr_type attr;
+      std::string value;
+      Entity::parsed_list list;
+    };
+    this->worker_.submit(make_worker_job(
+      list_update{entity, ha_attr, std::move(value), {}},
+      [](list_update &update) {
+        update.list = Entity::parse_list_attribute(update.attr, std::move(update.value));
+      },
+      [this](list_update &update) {
+        if (update.entity->set_attribute(update.attr, std::move(update.list)))
+          this->on_entity_changed_(update.entity, update.attr);
+      }));
+    return;
   } else {
-    entity->set_attribute(ha_attr, attr_value);
+    changed = entity->set_attribute(ha_attr, std::move(value));
   }
+  if (changed) this->on_entity_changed_(entity, ha_attr);
+}
 
+void NSPanelLovelace::on_entity_changed_(Entity *entity, ha_attr_type ha_attr) {
   ESP_LOGD(TAG, "HA update: %s %s='%s'",
-    entity_id.c_str(), attr.c_str(), 
+    entity->get_entity_id().c_str(), to_string(ha_attr),
     ha_attr == ha_attr_type::state
       ? entity->get_state().c_str()
       : entity->get_attribute(ha_attr).c_str());
@@ -2225,9 +2218,10 @@ void NSPanelLovelace::on_entity_attribute_update_(std::string entity_id, std::st
   // If there are lots of entity attributes that update within a short time
   // then this will queue lots of commands unnecessarily.
   // This re-schedules updates every time one happens within a 200ms period.
-  this->set_timeout(entity_id, 200, [this, entity_id] () {
+  this->set_timeout(entity->get_entity_id(), 200, [this, entity] () {
     if (this->force_current_page_update_) return;
     if (this->current_page_ == nullptr) return;
+    auto &entity_id = entity->get_entity_id();
 
     if (this->screensaver_ != nullptr && 
         this->current_page_->is_type(page_type::screensaver)) {
@@ -2283,7 +2277,24 @@ void NSPanelLovelace::send_weather_update_command_() {
   this->send_buffered_command_();
 }
 
-void NSPanelLovelace::on_weather_state_update_(std::string entity_id, std::string state) {
+void NSPanelLovelace::subscribe_weather_(ha_attr_type attr) {
+  api::global_api_server->subscribe_home_assistant_state(
+    this->weather_entity_id_,
+    optional<std::string>(attr == ha_attr_type::state ? "" : to_string(attr)),
+    [this, attr](std::string value) { this->on_weather_update_(attr, std::move(value)); });
+}
+
+void NSPanelLovelace::on_weather_update_(ha_attr_type attr, std::string value) {
+  switch (attr) {
+  case ha_attr_type::state: this->on_weather_state_update_(std::move(value)); break;
+  case ha_attr_type::temperature: this->on_weather_temperature_update_(std::move(value)); break;
+  case ha_attr_type::temperature_unit: this->on_weather_temperature_unit_update_(std::move(value)); break;
+  case ha_attr_type::forecast: this->on_weather_forecast_update_(std::move(value)); break;
+  default: break;
+  }
+}
+
+void NSPanelLovelace::on_weather_state_update_(std::string state) {
   if (this->screensaver_ == nullptr) return;
   auto item = this->screensaver_->get_item<WeatherItem>(0);
   if (item == nullptr) return;
@@ -2291,7 +2302,7 @@ void NSPanelLovelace::on_weather_state_update_(std::string entity_id, std::strin
   this->send_weather_update_command_();
 }
 
-void NSPanelLovelace::on_weather_temperature_update_(std::string entity_id, std::string temperature) {
+void NSPanelLovelace::on_weather_temperature_update_(std::string temperature) {
   if (this->screensaver_ == nullptr) return;
   auto item = this->screensaver_->get_item<WeatherItem>(0);
   if (item == nullptr) return;
@@ -2299,78 +2310,84 @@ void NSPanelLovelace::on_weather_temperature_update_(std::string entity_id, std:
   this->send_weather_update_command_();
 }
 
-void NSPanelLovelace::on_weather_temperature_unit_update_(std::string entity_id, std::string temperature_unit) {
+void NSPanelLovelace::on_weather_temperature_unit_update_(std::string temperature_unit) {
   if (this->screensaver_ == nullptr) return;
   WeatherItem::temperature_unit = std::move(temperature_unit);
   this->screensaver_->set_items_render_invalid();
   this->send_weather_update_command_();
 }
 
-void NSPanelLovelace::on_weather_forecast_update_(std::string entity_id, std::string forecast_json) {
+void NSPanelLovelace::on_weather_forecast_update_(std::string forecast_json) {
   if (this->screensaver_ == nullptr) return;
   // todo: check if we are on the screensaver otherwise don't update
   // todo: implement color updates: "color~background~tTime~timeAMPM~tDate~tMainText~tForecast1~tForecast2~tForecast3~tForecast4~tForecast1Val~tForecast2Val~tForecast3Val~tForecast4Val~bar~tMainTextAlt2~tTimeAdd"
 
-  ArduinoJson::StaticJsonDocument<200> filter;
-  filter[0]["datetime"] = true;
-  filter[0]["condition"] = true;
-  filter[0]["temperature"] = true;
+  const size_t item_count = this->screensaver_->get_items().size();
 
-  if (filter.overflowed()) {
-    ESP_LOGW(TAG, "Weather unparsable: filter overflowed");
-    return;
-  }
-  
   // Note: Unfortunately the json received is nearly 6KB!
-  //       We filter the variables to consume less but it is still a lot,
-  //       so we need to allocate an appropriate amount of memory to read it.
-  SpiRamJsonDocument doc(psram_available() ? 7680 : 6144);
-  ArduinoJson::DeserializationError error = ArduinoJson::deserializeJson(
-    doc, (char *)forecast_json.data(), DeserializationOption::Filter(filter));
-  App.feed_wdt();
+  //       Only the items which can be displayed are read (at least 2 to
+  //       check if the forecast is hourly) and the rest is never parsed.
+  struct forecast_update {
+    std::string json;
+    size_t max_items;
+    ForecastParser forecast;
+    bool ok;
+  };
+  this->worker_.submit(make_worker_job(
+    forecast_update{std::move(forecast_json), std::max<size_t>(item_count - 1, 2), {}, false},
+    [](forecast_update &update) {
+      update.ok = update.forecast.parse(update.json, update.max_items);
+      // the json isn't needed any more
+      std::string().swap(update.json);
+    },
+    [this](forecast_update &update) {
+      if (!update.ok) {
+        ESP_LOGW(TAG, "Weather unparsable: %s at %zu",
+          update.forecast.get_error(), update.forecast.get_error_position());
+        return;
+      }
+      this->render_weather_forecast_(update.forecast);
+    }));
+}
 
-  if (error || doc.overflowed()) {
-    ESP_LOGW(TAG, "Weather unparsable: %s", error ? error.c_str() : "doc overflow");
-    return;
-  }
+void NSPanelLovelace::render_weather_forecast_(const ForecastParser &forecast) {
+  if (this->screensaver_ == nullptr) return;
+  uint8_t index = 1, item_count = this->screensaver_->get_items().size();
 
   this->command_buffer_.clear();
 
   // check if forecast is hourly or daily
   auto weather_entity_is_hourly = false;
-  if (doc.size() > 1) {
-    auto date1 = doc[0]["datetime"].as<const char *>();
-    auto date2 = doc[1]["datetime"].as<const char *>();
+  if (forecast.size() > 1) {
     tm t{};
-    if (iso8601_to_tm(date1, t)) {
+    if (iso8601_to_tm(forecast[0].datetime, t)) {
       uint8_t hr = t.tm_hour;
-      if (iso8601_to_tm(date2, t) && t.tm_hour != hr) {
+      if (iso8601_to_tm(forecast[1].datetime, t) && t.tm_hour != hr) {
         weather_entity_is_hourly = true;
       }
     }
   }
 
   char buff[16] = {};
-  uint8_t index = 1, item_count = this->screensaver_->get_items().size();
 
-  for (const ArduinoJson::JsonObject &item : doc.as<ArduinoJson::JsonArray>()) {
+  for (size_t i = 0; i < forecast.size(); i++) {
+    const auto &item = forecast[i];
     // can only display the first 4 items (minus 1 for the current weather)
-    if (index == item_count)
+    if (index >= item_count)
       break;
 
     auto weatherItem = this->screensaver_->get_item<WeatherItem>(index);
     if (weatherItem == nullptr)
       continue;
 
-    weatherItem->set_icon_by_weather_condition(
-        item["condition"].as<std::string>());
+    weatherItem->set_icon_by_weather_condition(item.condition);
 
     // icon displayName
     // todo: import temperature symbol from config
     tm t{};
     // Parse date e.g. 2023-08-22T21:00:00+00:00
-    if (!iso8601_to_tm(item["datetime"], t)) {
-      ESP_LOGW(TAG, "Weather 'datetime' unparsable: %s", item["datetime"].as<const char *>());
+    if (!iso8601_to_tm(item.datetime, t)) {
+      ESP_LOGW(TAG, "Weather 'datetime' unparsable: %s", item.datetime);
       // return;
       t = { 
         // second, minute, hour
@@ -2422,7 +2439,8 @@ void NSPanelLovelace::on_weather_forecast_update_(std::string entity_id, std::st
       }
     }
     
-    snprintf(buff, sizeof(buff), "%.1f", item["temperature"].as<float>());
+    snprintf(buff, sizeof(buff), "%.1f",
+      std::isnan(item.temperature) ? 0.0f : item.temperature);
     weatherItem->set_value(buff);
 
     ++index;
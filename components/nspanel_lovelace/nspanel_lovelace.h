@@ -5,8 +5,8 @@
 #include <functional>
 #include <memory>
 #include <map>
-#include <queue>
 #include <stdint.h>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -35,9 +35,15 @@
 #include "esphome/components/time/real_time_clock.h"
 #endif
 
+#include "command_queue.h"
 #include "config.h"
 #include "entity.h"
+#include "forecast_parser.h"
+#include "frame_parser.h"
+#include "lookup_index.h"
 #include "types.h"
+#include "uart_receiver.h"
+#include "worker.h"
 #include "helpers.h"
 #include "page_base.h"
 #include "card_base.h"
@@ -108,6 +114,8 @@ public:
   // Note: this can be used without parameters to update the display without changing the levels
   void set_display_dim(uint8_t inactive = UINT8_MAX, uint8_t active = UINT8_MAX);
   void set_weather_entity_id(const std::string &weather_entity_id) { this->weather_entity_id_ = weather_entity_id; }
+  void set_command_queue_size(size_t size) { this->command_scheduler_.set_capacity(size); }
+  void set_uart_rx_task(bool enabled) { this->use_uart_rx_task_ = enabled; }
 
   void render_screensaver() { this->render_page_(render_page_option::screensaver); }
   void render_next_page() { this->render_page_(render_page_option::next); }
@@ -138,7 +146,8 @@ public:
 
   void dump_config() override;
 
-  void add_incoming_msg_callback(std::function<void(std::string)> callback) { this->incoming_msg_callback_.add(std::move(callback)); }
+  // note: the message is only valid for the duration of the callback
+  void add_incoming_msg_callback(std::function<void(std::string_view)> callback) { this->incoming_msg_callback_.add(std::move(callback)); }
 
 #ifdef TEST_DEVICE_MODE
   // Only used to simulate TFT commands on test devices
@@ -167,23 +176,24 @@ protected:
 #endif
   void send_nextion_command_(const std::string &command);
 
-  void subscribe_homeassistant_state_attr(
-      void (NSPanelLovelace::*callback)(std::string, std::string, std::string),
-      std::string entity_id, std::string attribute) {
-    auto f = std::bind(callback, this, entity_id, attribute, std::placeholders::_1);
-    api::global_api_server->
-      subscribe_home_assistant_state(entity_id, optional<std::string>(attribute), f);
-  }
+  // HA subscriptions are identified by a handle made of the index of the
+  // entity in entities_ and the attribute (in the lower bits)
+  static constexpr uint8_t HA_SUBSCRIPTION_ATTR_BITS = 6u;
+  static constexpr size_t HA_SUBSCRIPTION_MAX_ENTITIES = 1u << (16u - HA_SUBSCRIPTION_ATTR_BITS);
+  bool subscribe_entity_(size_t entity_index, ha_attr_type attr);
 
-  bool process_data_();
+  void process_data_();
+  void process_uart_receiver_();
+  void process_frame_result_(frame_result result, const uint8_t *data, size_t len);
   size_t find_page_index_by_uuid_(const std::string &uuid) const;
   const std::string &try_replace_uuid_with_entity_id_(const std::string &uuid_or_entity_id);
-  void process_command_(const std::string &message);
+  void process_command_(std::string_view message);
   void send_buffered_command_();
   void process_display_command_queue_();
-  void process_button_press_(std::string &entity_id,
-    const std::string &button_type,
-    const std::string &value = "", bool called_from_timeout = false);
+  void process_button_press_(std::string_view internal_id,
+    button_action action, std::string_view value = {});
+  // Performs the action stored by process_button_press_()
+  void execute_button_press_();
   StatefulPageItem* get_page_item_(const std::string &uuid);
   Entity* get_entity_(const std::string &entity_id);
 
@@ -230,24 +240,30 @@ protected:
     const std::string& service,
     const std::map<std::string, std::string> &data,
     const std::map<std::string, std::string> &data_template = {});
-  void on_entity_state_update_(std::string entity_id, std::string state);
-  void on_entity_attribute_update_(
-    std::string entity_id, std::string attr_name, std::string attr_value);
-
-  void on_weather_state_update_(std::string entity_id, std::string state);
-  void on_weather_temperature_update_(std::string entity_id, std::string temperature);
-  void on_weather_temperature_unit_update_(std::string entity_id, std::string temperature_unit);
-  void on_weather_forecast_update_(std::string entity_id, std::string forecast_json);
+  void on_entity_update_(uint16_t handle, std::string value);
+  // Schedules a render after the entity was updated by HA
+  void on_entity_changed_(Entity *entity, ha_attr_type attr);
+
+  void subscribe_weather_(ha_attr_type attr);
+  void on_weather_update_(ha_attr_type attr, std::string value);
+  void on_weather_state_update_(std::string state);
+  void on_weather_temperature_update_(std::string temperature);
+  void on_weather_temperature_unit_update_(std::string temperature_unit);
+  void on_weather_forecast_update_(std::string forecast_json);
+  void render_weather_forecast_(const ForecastParser &forecast);
   void send_weather_update_command_();
   std::string weather_entity_id_;
   std::string language_;
 
-  std::queue<std::string> command_queue_;
+  CommandScheduler command_scheduler_;
+  SentCommandCache sent_command_cache_;
   unsigned long command_last_sent_ = 0;
+  // set while handling an event from the panel, commands are queued in the interactive lane
+  bool interactive_ = false;
 
   bool button_press_timeout_set_ = false;
   std::string button_press_uuid_;
-  std::string button_press_type_;
+  button_action button_press_action_ = button_action::unknown;
   std::string button_press_value_;
 
   uint8_t current_page_index_ = 0;
@@ -258,12 +274,29 @@ protected:
   std::vector<std::shared_ptr<Entity>> entities_;
   std::vector<std::shared_ptr<Page>> pages_;
   std::vector<std::shared_ptr<StatefulPageItem>> stateful_page_items_;
+  // the item shown on the popup page
   StatefulPageItem* cached_page_item_ = nullptr;
-  Entity* cached_entity_ = nullptr;
-
-  CallbackManager<void(std::string)> incoming_msg_callback_;
 
-  std::vector<uint8_t> buffer_;
+  struct entity_id_key {
+    const std::string &operator()(const Entity *entity) const { return entity->get_entity_id(); }
+  };
+  struct page_item_uuid_key {
+    const std::string &operator()(const StatefulPageItem *item) const { return item->get_uuid(); }
+  };
+  HashIndex<Entity, entity_id_key> entity_index_;
+  UuidIndex<StatefulPageItem, page_item_uuid_key> page_item_index_;
+
+  CallbackManager<void(std::string_view)> incoming_msg_callback_;
+
+  FrameParser frame_parser_;
+  // Only created when frames are received on a separate task
+  std::unique_ptr<UartReceiver> uart_receiver_;
+  bool use_uart_rx_task_ = false;
+  uint32_t uart_rx_dropped_count_ = 0;
+  // Parses forecasts and list attributes off the main loop
+  Worker worker_;
+  // Staging buffer for outgoing frames, reused to avoid allocations
+  std::vector<uint8_t> tx_buffer_;
   std::string command_buffer_;
 
 #ifdef USE_NSPANEL_TFT_UPLOAD
@@ -143,6 +143,8 @@ bool NSPanelLovelace::upload_tft(const std::string &url) {
   this->set_reparse_mode_(false);
 
   this->is_updating_ = true;
+  // the upload responses are read directly from the UART
+  if (this->uart_receiver_ != nullptr) this->uart_receiver_->pause();
 
   HTTPClient http;
   http.setTimeout(15000);  // Yes 15 seconds.... Helps 8266s along
@@ -151,6 +153,7 @@ bool NSPanelLovelace::upload_tft(const std::string &url) {
 
   if (!begin_status) {
     this->is_updating_ = false;
+    if (this->uart_receiver_ != nullptr) this->uart_receiver_->resume();
     ESP_LOGD(TAG, "connection failed");
     ExternalRAMAllocator<uint8_t> allocator(ExternalRAMAllocator<uint8_t>::ALLOW_FAILURE);
     allocator.deallocate(this->transfer_buffer_, this->transfer_buffer_size_);
@@ -289,6 +292,7 @@ bool NSPanelLovelace::upload_tft(const std::string &url) {
 }
 
 bool NSPanelLovelace::upload_end_(bool successful) {
+  if (this->uart_receiver_ != nullptr) this->uart_receiver_->resume();
   if (!successful) return successful;
   ESP_LOGD(TAG, "Restarting Nextion");
   this->soft_reset_display();
@@ -216,6 +216,8 @@ bool NSPanelLovelace::upload_tft(const std::string &url /*, uint32_t baud_rate*/
   }
 
   this->is_updating_ = true;
+  // the upload responses are read directly from the UART
+  if (this->uart_receiver_ != nullptr) this->uart_receiver_->pause();
 
   std::string recv_res;
   if (Configuration::get_model() != nspanel_model_t::unknown) {
@@ -442,6 +444,7 @@ bool NSPanelLovelace::upload_end_(bool successful) {
     this->parent_->set_baud_rate(this->default_baud_rate_);
     this->parent_->load_settings();
   }
+  if (this->uart_receiver_ != nullptr) this->uart_receiver_->resume();
   this->soft_reset_display();
   // todo: Why do we need to reset the ESP after a TFT update?
   //       The TFT should send us the startup command when reset
@@ -133,8 +133,8 @@ PageItem_Value::PageItem_Value(
     ISetRenderInvalid(parent),
     value_(value) {}
 
-bool PageItem_Value::set_value(const std::string &value) {
-  this->value_ = value;
+bool PageItem_Value::set_value(std::string value) {
+  this->value_ = std::move(value);
   set_render_invalid_();
   return true;
 }
@@ -214,6 +214,7 @@ void StatefulPageItem::on_entity_type_change(const char *type) {
   this->icon_value_overridden_ = false;
 
   this->set_on_state_callback_(type);
+  this->entity_->set_subscriber_attribute_mask(this, this->get_attribute_mask_(type));
 
   this->set_render_invalid();
 
@@ -256,6 +257,11 @@ void StatefulPageItem::on_entity_attribute_change(ha_attr_type attr, const std::
   this->set_render_invalid();
 }
 
+uint64_t StatefulPageItem::get_attribute_mask_(const char *type) const {
+  return attribute_bit(ha_attr_type::device_class) |
+    attribute_bit(ha_attr_type::media_content_type);
+}
+
 void StatefulPageItem::set_on_state_callback_(const char *type) {
   if (type == entity_type::light ||
       type == entity_type::switch_ ||
@@ -309,9 +315,9 @@ void StatefulPageItem::state_on_off_fn(StatefulPageItem *me) {
     return;
   }
 
-  if (me->is_state(entity_state::on)) {
+  if (me->is_state(entity_state_t::on)) {
     me->icon_color_ = 64909u; // yellow
-  } else if (me->is_state(entity_state::off)) {
+  } else if (me->is_state(entity_state_t::off)) {
     me->icon_color_ = 17299u; // blue
   } else {
     me->icon_color_ = 38066u; // grey
@@ -319,7 +325,7 @@ void StatefulPageItem::state_on_off_fn(StatefulPageItem *me) {
 }
 
 void StatefulPageItem::state_binary_sensor_fn(StatefulPageItem *me) {
-  if (me->is_state(entity_state::on)) {
+  if (me->is_state(entity_state_t::on)) {
     if (!me->icon_color_overridden_)
       me->icon_color_ = 64909u; // yellow
     if (!me->icon_value_overridden_) {
@@ -329,7 +335,7 @@ void StatefulPageItem::state_binary_sensor_fn(StatefulPageItem *me) {
     }
   } else {
     if (!me->icon_color_overridden_) {
-      if (me->is_state(entity_state::off))
+      if (me->is_state(entity_state_t::off))
         me->icon_color_ = 17299u; // blue
       else
         me->icon_color_ = 38066u; // grey
@@ -344,9 +350,9 @@ void StatefulPageItem::state_binary_sensor_fn(StatefulPageItem *me) {
 
 void StatefulPageItem::state_cover_fn(StatefulPageItem *me) {
   if (!me->icon_color_overridden_) {
-    if (me->is_state(entity_state::closed))
+    if (me->is_state(entity_state_t::closed))
       me->icon_color_ = 17299u; // blue
-    else if (me->is_state(entity_state::open))
+    else if (me->is_state(entity_state_t::open))
       me->icon_color_ = 64909u; // yellow
     else 
       me->icon_color_ = 38066u; // grey
@@ -356,7 +362,7 @@ void StatefulPageItem::state_cover_fn(StatefulPageItem *me) {
     std::array<const char *, 4> icons{};
     if (try_get_value(COVER_MAP, icons,
         me->get_attribute(ha_attr_type::device_class))) {
-      if (me->is_state(entity_state::closed))
+      if (me->is_state(entity_state_t::closed))
         me->icon_value_ = icons.at(1);
       else
         me->icon_value_ = icons.at(0);
@@ -373,16 +379,17 @@ void StatefulPageItem::state_climate_fn(StatefulPageItem *me) {
   }
 
   if (!me->icon_color_overridden_) {
+    auto state_id = me->get_state_id();
     me->icon_color_ = 64512U;
-    if (state == entity_state::auto_ ||
-        state == entity_state::heat_cool) {
+    if (state_id == entity_state_t::auto_ ||
+        state_id == entity_state_t::heat_cool) {
       me->icon_color_ = 1024U;
-    } else if (state == entity_state::off ||
-        state == entity_state::fan_only) {
+    } else if (state_id == entity_state_t::off ||
+        state_id == entity_state_t::fan_only) {
       me->icon_color_ = 35921U;
-    } else if (state == entity_state::cool) {
+    } else if (state_id == entity_state_t::cool) {
       me->icon_color_ = 11487U;
-    } else if (state == entity_state::dry) {
+    } else if (state_id == entity_state_t::dry) {
       me->icon_color_ = 60897U;
     }
   }
@@ -393,9 +400,9 @@ void StatefulPageItem::state_media_fn(StatefulPageItem *me) {
     return;
   }
 
-  if (me->is_state(entity_state::off)) {
+  if (me->is_state(entity_state_t::off)) {
     me->icon_color_ = 17299u; // blue
-  } else if (!me->is_state(entity_state::unavailable)) {
+  } else if (!me->is_state(entity_state_t::unavailable)) {
     me->icon_color_ = 64909u; // yellow
   } else {
     me->icon_color_ = 38066u; // grey
@@ -417,7 +424,7 @@ void StatefulPageItem::state_alarm_fn(StatefulPageItem *me) {
 // todo: also change colour
 void StatefulPageItem::state_sun_fn(StatefulPageItem *me) {
   if (me->icon_value_overridden_) return;
-  if (me->is_state(entity_state::above_horizon))
+  if (me->is_state(entity_state_t::above_horizon))
     me->icon_value_ = icon_t::weather_sunset_up;
   else
     me->icon_value_ = icon_t::weather_sunset_down;
@@ -425,7 +432,7 @@ void StatefulPageItem::state_sun_fn(StatefulPageItem *me) {
 // todo: also change colour
 void StatefulPageItem::state_lock_fn(StatefulPageItem *me) {
   if (me->icon_value_overridden_) return;
-  if (me->is_state(entity_state::unlocked))
+  if (me->is_state(entity_state_t::unlocked))
     me->icon_value_ = icon_t::lock_open;
   else
     me->icon_value_ = icon_t::lock;
@@ -151,7 +151,7 @@ public:
   const std::string &get_value() const { return this->value_; }
   const std::string &get_value_postfix() const { return this->value_postfix_; }
 
-  virtual bool set_value(const std::string &value);
+  virtual bool set_value(std::string value);
   virtual void set_value_postfix(const std::string &value_postfix);
 
 protected:
@@ -194,12 +194,17 @@ public:
   bool is_type(const char *type) const { return this->entity_->is_type(type); }
   const char *get_type() const { return this ->entity_->get_type(); }
   const std::string &get_entity_id() const { return this->entity_->get_entity_id(); }
+  bool is_state(entity_state_t state) const { return this->entity_->is_state(state); }
   bool is_state(const std::string &state) const { return this->entity_->is_state(state); }
+  entity_state_t get_state_id() const { return this->entity_->get_state_id(); }
   const std::string &get_state() const { return this->entity_->get_state(); }
   const std::string &get_attribute(
       ha_attr_type attr, const std::string &default_value = "") const {
     return this->entity_->get_attribute(attr, default_value);
   }
+  float get_attribute_number(ha_attr_type attr, float default_value = 0.0f) const {
+    return this->entity_->get_attribute_number(attr, default_value);
+  }
   Entity* get_entity() const { return this->entity_.get(); }
 
 protected:
@@ -209,6 +214,9 @@ protected:
   const char *render_type_;
 
   virtual void set_on_state_callback_(const char *type);
+  // The attributes on_entity_attribute_change() needs to be notified of
+  // for the entity type, updated whenever the type changes
+  virtual uint64_t get_attribute_mask_(const char *type) const;
 
   static void state_on_off_fn(StatefulPageItem *me);
   static void state_binary_sensor_fn(StatefulPageItem *me);
@@ -130,7 +130,7 @@ WeatherItem::WeatherItem(
 void WeatherItem::accept(PageItemVisitor& visitor) { visitor.visit(*this); }
 
 // valid conditions are found in weather_type
-void WeatherItem::set_icon_by_weather_condition(const std::string &condition) {
+void WeatherItem::set_icon_by_weather_condition(const char *condition) {
   Icon icon{};
   if (!try_get_value(WEATHER_ICON_MAP, icon, condition)) return;
   this->icon_color_ = icon.color;
@@ -138,10 +138,10 @@ void WeatherItem::set_icon_by_weather_condition(const std::string &condition) {
   this->set_render_invalid();
 }
 
-bool WeatherItem::set_value(const std::string &value) {
+bool WeatherItem::set_value(std::string value) {
   if (sscanf(value.c_str(), "%f", &this->float_value_) != 1)
     return false;
-  this->value_ = value;
+  this->value_ = std::move(value);
   this->render_invalid_ = true;
   return true;
 }
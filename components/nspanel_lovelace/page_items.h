@@ -92,8 +92,11 @@ public:
 
   void accept(PageItemVisitor& visitor) override;
 
-  void set_icon_by_weather_condition(const std::string &condition);
-  bool set_value(const std::string &value) override;
+  void set_icon_by_weather_condition(const char *condition);
+  void set_icon_by_weather_condition(const std::string &condition) {
+    this->set_icon_by_weather_condition(condition.c_str());
+  }
+  bool set_value(std::string value) override;
 
   // The temperature unit all weather items will use
   static std::string temperature_unit;
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+// Fixed capacity byte FIFO. Capacity must be a power of 2 so the
+// read/write positions can be wrapped with a mask.
+template<size_t Capacity>
+class RingBuffer {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+    "RingBuffer capacity must be a power of 2");
+
+public:
+  static constexpr size_t capacity() { return Capacity; }
+  size_t size() const { return this->size_; }
+  size_t free() const { return Capacity - this->size_; }
+  bool empty() const { return this->size_ == 0; }
+  bool full() const { return this->size_ == Capacity; }
+
+  // Byte at the given offset from the read position (offset must be < size())
+  uint8_t peek(size_t offset = 0) const {
+    return this->data_[(this->head_ + offset) & (Capacity - 1)];
+  }
+
+  // Copies 'len' bytes starting at 'offset' from the read position into 'dst'
+  void copy_to(uint8_t *dst, size_t offset, size_t len) const {
+    size_t start = (this->head_ + offset) & (Capacity - 1);
+    size_t first = std::min(len, Capacity - start);
+    std::memcpy(dst, &this->data_[start], first);
+    if (first < len)
+      std::memcpy(dst + first, &this->data_[0], len - first);
+  }
+
+  // Discard 'len' bytes from the read position
+  void pop(size_t len) {
+    if (len > this->size_) len = this->size_;
+    this->head_ = (this->head_ + len) & (Capacity - 1);
+    this->size_ -= len;
+  }
+
+  void clear() {
+    this->head_ = 0;
+    this->size_ = 0;
+  }
+
+  // Contiguous free region at the write position, used to read
+  // directly into the buffer. Call commit() with the bytes written.
+  uint8_t *write_region(size_t &len) {
+    size_t tail = (this->head_ + this->size_) & (Capacity - 1);
+    len = this->full() ? 0 : std::min(this->free(), Capacity - tail);
+    return &this->data_[tail];
+  }
+  void commit(size_t len) {
+    this->size_ += std::min(len, this->free());
+  }
+
+protected:
+  std::array<uint8_t, Capacity> data_{};
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
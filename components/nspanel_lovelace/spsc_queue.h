@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <stddef.h>
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+// Lock-free fixed capacity FIFO for passing items between two tasks.
+// Only one task may push and only one (other) task may pop.
+// Capacity must be a power of 2 so the positions can be wrapped with a mask.
+template<typename T, size_t Capacity>
+class SpscQueue {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+    "SpscQueue capacity must be a power of 2");
+
+public:
+  static constexpr size_t capacity() { return Capacity; }
+
+  // Producer only, returns false if the queue is full
+  bool push(const T &item) {
+    const size_t tail = this->tail_.load(std::memory_order_relaxed);
+    if (tail - this->head_.load(std::memory_order_acquire) == Capacity)
+      return false;
+    this->items_[tail & (Capacity - 1)] = item;
+    this->tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only, returns false if the queue is empty
+  bool pop(T &item) {
+    const size_t head = this->head_.load(std::memory_order_relaxed);
+    if (head == this->tail_.load(std::memory_order_acquire))
+      return false;
+    item = this->items_[head & (Capacity - 1)];
+    this->head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // note: only a snapshot when called while the other task is using the queue
+  size_t size() const {
+    return this->tail_.load(std::memory_order_acquire) -
+      this->head_.load(std::memory_order_acquire);
+  }
+  bool empty() const { return this->size() == 0; }
+
+protected:
+  std::array<T, Capacity> items_{};
+  // the positions are only ever incremented (and wrap around with the mask)
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+};
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "string_list.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+static inline bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline bool is_quote(char c) { return c == '\'' || c == '"'; }
+
+// note: the items are never longer than the text they are read from
+//       so they can be written over the string as it is parsed
+size_t parse_python_list(std::string &str, std::vector<uint16_t> &offsets,
+    size_t max_items) {
+  const size_t len = str.size();
+  size_t read = 0, write = 0, count = 0;
+  // every item except the last one ends with a comma
+  offsets.reserve(offsets.size() + std::min<size_t>(
+    std::count(str.begin(), str.end(), ',') + 1u, max_items));
+
+  while (read < len && is_space(str[read])) read++;
+  char close = '\0';
+  if (read < len && (str[read] == '[' || str[read] == '(')) {
+    close = str[read] == '[' ? ']' : ')';
+    read++;
+  }
+
+  while (read < len && count < max_items) {
+    const char c = str[read];
+    if (c == close) break;
+    if (c == ',' || is_space(c)) {
+      read++;
+      continue;
+    }
+
+    const size_t item_start = write + (count > 0 ? 1 : 0);
+    size_t item_end = item_start;
+    bool quoted = false;
+    // the item ends at the first comma which isn't quoted
+    while (read < len && str[read] != ',' && str[read] != close) {
+      const char quote = str[read++];
+      if (!is_quote(quote)) {
+        // unquoted text is only used when the item has no quoted string
+        if (!quoted) {
+          str[item_end++] = quote;
+        }
+        continue;
+      }
+      if (!quoted) item_end = item_start;
+      while (read < len && str[read] != quote) {
+        // escaped characters are kept as they are (i.e. \' is ')
+        if (str[read] == '\\' && read + 1 < len) read++;
+        if (!quoted) str[item_end++] = str[read];
+        read++;
+      }
+      read++; // closing quote
+      quoted = true;
+    }
+    if (!quoted) {
+      while (item_end > item_start && is_space(str[item_end - 1])) item_end--;
+    }
+    if (item_end == item_start) continue;
+    if (item_end > UINT16_MAX) break;
+
+    if (count > 0) str[write] = ',';
+    write = item_end;
+    offsets.push_back(static_cast<uint16_t>(item_end));
+    count++;
+  }
+
+  str.resize(write);
+  return count;
+}
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
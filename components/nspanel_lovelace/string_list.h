@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+// Parses the string representation of a Python list (enums, strings etc) in place.
+// The items are written to the start of the same string separated by ',' and the
+// end offset of each item is added to 'offsets', so items can contain commas.
+// Quoted items can contain either quote character, the first quoted string of an
+// unquoted item is used as its value (i.e. "<ColorMode.XY: 'xy'>" is "xy").
+// A value which is not a list is treated as a comma separated list.
+// Empty items are ignored. Returns the number of items stored.
+// todo: remove this when esphome starts sending properly formatted array strings
+size_t parse_python_list(std::string &str, std::vector<uint16_t> &offsets,
+    size_t max_items = SIZE_MAX);
+
+/**
+ * Read only view of a list stored as a single buffer and the end offset of
+ * each item (see parse_python_list). Items are separated by one character
+ * in the buffer which is not part of either item.
+ *
+ * The view is only valid while the buffer and offsets are unchanged.
+ */
+class StringListView {
+public:
+  class iterator {
+  public:
+    iterator(const StringListView *list, size_t index) : list_(list), index_(index) {}
+    std::string_view operator*() const { return (*this->list_)[this->index_]; }
+    iterator &operator++() { this->index_++; return *this; }
+    bool operator!=(const iterator &other) const { return this->index_ != other.index_; }
+
+  protected:
+    const StringListView *list_;
+    size_t index_;
+  };
+
+  StringListView() = default;
+  StringListView(std::string_view buffer, const std::vector<uint16_t> &offsets) :
+      buffer_(buffer), offsets_(offsets.data()), size_(offsets.size()) {}
+
+  size_t size() const { return this->size_; }
+  bool empty() const { return this->size_ == 0; }
+  std::string_view operator[](size_t index) const {
+    const size_t start = index == 0 ? 0 : this->offsets_[index - 1] + 1u;
+    return this->buffer_.substr(start, this->offsets_[index] - start);
+  }
+  // Returns an empty string if the index is out of range
+  std::string_view at(size_t index) const {
+    return index < this->size_ ? (*this)[index] : std::string_view();
+  }
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, this->size_); }
+
+  bool contains(std::string_view value) const {
+    for (auto item : *this) {
+      if (item == value) return true;
+    }
+    return false;
+  }
+
+  // Appends the items to the buffer separated by delimiter
+  std::string &append_to(std::string &buffer, char delimiter) const {
+    for (size_t i = 0; i < this->size_; i++) {
+      if (i > 0) buffer.append(1, delimiter);
+      buffer.append((*this)[i]);
+    }
+    return buffer;
+  }
+
+protected:
+  std::string_view buffer_;
+  const uint16_t *offsets_ = nullptr;
+  size_t size_ = 0;
+};
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
@@ -134,13 +134,58 @@ struct translation_item {
   static constexpr const char* dow_sat = "dow_sat";
 };
 
-// NOTE: This map is dynamically generated by the esphome build script from a
-//       json file based on the users selected language (default 'en')
-extern FrozenCharMap<const char *, TRANSLATION_MAP_SIZE> TRANSLATION_MAP;
+using translation_table_t = std::array<std::pair<const char *, const char *>, TRANSLATION_MAP_SIZE>;
+using translation_seeds_t = std::array<int32_t, TRANSLATION_MAP_SIZE>;
+
+// NOTE: These tables are dynamically generated by the esphome build script from a
+//       json file based on the users selected language (default 'en').
+//       They form a minimal perfect hash of the translation keys:
+//         seed = TRANSLATION_SEEDS[fnv1a_hash(key) % size]
+//         slot = seed < 0 ? -seed - 1 : fnv1a_hash(key, seed) % size
+//       so every key is found with a single string comparison.
+extern const translation_table_t TRANSLATION_MAP;
+extern const translation_seeds_t TRANSLATION_SEEDS;
+
+inline constexpr size_t get_translation_slot(
+    const translation_seeds_t &seeds, std::string_view key) {
+  const int32_t seed = seeds[fnv1a_hash(key) % TRANSLATION_MAP_SIZE];
+  if (seed < 0) return static_cast<size_t>(-seed - 1);
+  return fnv1a_hash(key, static_cast<uint32_t>(seed)) % TRANSLATION_MAP_SIZE;
+}
+
+// Checks every key is stored in the slot the lookup expects (used by the generated code)
+inline constexpr bool is_valid_translation_table(
+    const translation_table_t &table, const translation_seeds_t &seeds) {
+  for (size_t i = 0; i < TRANSLATION_MAP_SIZE; i++) {
+    if (get_translation_slot(seeds, table[i].first) != i) return false;
+  }
+  return true;
+}
+
+static inline bool try_get_translation(const char *key, const char *&value) {
+  if (key == nullptr || key[0] == '\0') return false;
+  const auto &entry = TRANSLATION_MAP[get_translation_slot(TRANSLATION_SEEDS, key)];
+  if (std::strcmp(entry.first, key) != 0) return false;
+  value = entry.second;
+  return true;
+}
+
+static inline bool try_get_translation(const std::string &key, const char *&value) {
+  return try_get_translation(key.c_str(), value);
+}
+
+// For keys which are not null terminated (i.e. list attribute items)
+static inline bool try_get_translation(std::string_view key, const char *&value) {
+  if (key.empty()) return false;
+  const auto &entry = TRANSLATION_MAP[get_translation_slot(TRANSLATION_SEEDS, key)];
+  if (key != entry.first) return false;
+  value = entry.second;
+  return true;
+}
 
 static inline const char *get_translation(const char *key) {
   auto ret = key;
-  try_get_value(TRANSLATION_MAP, ret, key);
+  try_get_translation(key, ret);
   return ret;
 }
 
@@ -2,8 +2,10 @@
 
 #include <array>
 #include <cassert>
+#include <cstring>
 #include <stdint.h>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "helpers.h"
@@ -206,6 +208,141 @@ struct entity_state {
 
 };
 
+// The well known states are interned into this enum when they are set
+enum class entity_state_t : uint8_t {
+  // free text (the value is stored as a string)
+  other,
+  unknown,
+  unavailable,
+  on,
+  off,
+  // cover
+  open,
+  closed,
+  // media_player
+  playing,
+  paused,
+  // lock
+  locked,
+  unlocked,
+  // alarm_control_panel
+  disarmed,
+  arming,
+  pending,
+  triggered,
+  armed_home,
+  armed_away,
+  armed_night,
+  armed_vacation,
+  armed_custom_bypass,
+  // sun
+  above_horizon,
+  below_horizon,
+  // vacuum
+  docked,
+  // person
+  home,
+  not_home,
+  // timer
+  idle,
+  // climate
+  cool,
+  dry,
+  heat,
+  heat_cool,
+  fan_only,
+  auto_,
+};
+
+static constexpr const char* entity_state_names [] = {
+  "",
+  entity_state::unknown,
+  entity_state::unavailable,
+  entity_state::on,
+  entity_state::off,
+  // cover
+  entity_state::open,
+  entity_state::closed,
+  // media_player
+  entity_state::playing,
+  entity_state::paused,
+  // lock
+  entity_state::locked,
+  entity_state::unlocked,
+  // alarm_control_panel
+  entity_state::disarmed,
+  entity_state::arming,
+  entity_state::pending,
+  entity_state::triggered,
+  entity_state::armed_home,
+  entity_state::armed_away,
+  entity_state::armed_night,
+  entity_state::armed_vacation,
+  entity_state::armed_custom_bypass,
+  // sun
+  entity_state::above_horizon,
+  entity_state::below_horizon,
+  // vacuum
+  entity_state::docked,
+  // person
+  entity_state::home,
+  entity_state::not_home,
+  // timer
+  entity_state::idle,
+  // climate
+  entity_state::cool,
+  entity_state::dry,
+  entity_state::heat,
+  entity_state::heat_cool,
+  entity_state::fan_only,
+  entity_state::auto_,
+};
+
+inline const char *to_string(entity_state_t state) {
+  if ((size_t)state >= (sizeof(entity_state_names) / sizeof(*entity_state_names)))
+    return nullptr;
+  return entity_state_names[(uint8_t)state];
+}
+
+inline entity_state_t to_entity_state(std::string_view state) {
+  entity_state_t ret;
+  switch (fnv1a_hash(state)) {
+  case fnv1a_hash(entity_state::unknown): ret = entity_state_t::unknown; break;
+  case fnv1a_hash(entity_state::unavailable): ret = entity_state_t::unavailable; break;
+  case fnv1a_hash(entity_state::on): ret = entity_state_t::on; break;
+  case fnv1a_hash(entity_state::off): ret = entity_state_t::off; break;
+  case fnv1a_hash(entity_state::open): ret = entity_state_t::open; break;
+  case fnv1a_hash(entity_state::closed): ret = entity_state_t::closed; break;
+  case fnv1a_hash(entity_state::playing): ret = entity_state_t::playing; break;
+  case fnv1a_hash(entity_state::paused): ret = entity_state_t::paused; break;
+  case fnv1a_hash(entity_state::locked): ret = entity_state_t::locked; break;
+  case fnv1a_hash(entity_state::unlocked): ret = entity_state_t::unlocked; break;
+  case fnv1a_hash(entity_state::disarmed): ret = entity_state_t::disarmed; break;
+  case fnv1a_hash(entity_state::arming): ret = entity_state_t::arming; break;
+  case fnv1a_hash(entity_state::pending): ret = entity_state_t::pending; break;
+  case fnv1a_hash(entity_state::triggered): ret = entity_state_t::triggered; break;
+  case fnv1a_hash(entity_state::armed_home): ret = entity_state_t::armed_home; break;
+  case fnv1a_hash(entity_state::armed_away): ret = entity_state_t::armed_away; break;
+  case fnv1a_hash(entity_state::armed_night): ret = entity_state_t::armed_night; break;
+  case fnv1a_hash(entity_state::armed_vacation): ret = entity_state_t::armed_vacation; break;
+  case fnv1a_hash(entity_state::armed_custom_bypass): ret = entity_state_t::armed_custom_bypass; break;
+  case fnv1a_hash(entity_state::above_horizon): ret = entity_state_t::above_horizon; break;
+  case fnv1a_hash(entity_state::below_horizon): ret = entity_state_t::below_horizon; break;
+  case fnv1a_hash(entity_state::docked): ret = entity_state_t::docked; break;
+  case fnv1a_hash(entity_state::home): ret = entity_state_t::home; break;
+  case fnv1a_hash(entity_state::not_home): ret = entity_state_t::not_home; break;
+  case fnv1a_hash(entity_state::idle): ret = entity_state_t::idle; break;
+  case fnv1a_hash(entity_state::cool): ret = entity_state_t::cool; break;
+  case fnv1a_hash(entity_state::dry): ret = entity_state_t::dry; break;
+  case fnv1a_hash(entity_state::heat): ret = entity_state_t::heat; break;
+  case fnv1a_hash(entity_state::heat_cool): ret = entity_state_t::heat_cool; break;
+  case fnv1a_hash(entity_state::fan_only): ret = entity_state_t::fan_only; break;
+  case fnv1a_hash(entity_state::auto_): ret = entity_state_t::auto_; break;
+  default: return entity_state_t::other;
+  }
+  return state == to_string(ret) ? ret : entity_state_t::other;
+}
+
 struct generic_type {
   static constexpr const char* enable = "enable";
   static constexpr const char* disable = "disable";
@@ -335,6 +472,100 @@ struct entity_type {
   static constexpr const char* delete_ = "delete";
 };
 
+// Identifies the entity type (domain) without string comparisons,
+// to_string() returns the matching entity_type value
+enum class entity_kind : uint8_t {
+  unknown,
+  scene,
+  script,
+  light,
+  switch_,
+  input_boolean,
+  automation,
+  fan,
+  lock,
+  button,
+  input_button,
+  input_select,
+  number,
+  input_number,
+  vacuum,
+  timer,
+  person,
+  service,
+
+  cover,
+  sensor,
+  binary_sensor,
+  input_text,
+  text,
+  select,
+  alarm_control_panel,
+  media_player,
+  sun,
+  climate,
+  weather,
+
+  // internal (non HA) types
+  nav_up,
+  nav_prev,
+  nav_next,
+  uuid,
+  navigate,
+  navigate_uuid,
+  itext,
+  delete_,
+};
+
+static constexpr const char* entity_kind_names [] = {
+  nullptr,
+  entity_type::scene,
+  entity_type::script,
+  entity_type::light,
+  entity_type::switch_,
+  entity_type::input_boolean,
+  entity_type::automation,
+  entity_type::fan,
+  entity_type::lock,
+  entity_type::button,
+  entity_type::input_button,
+  entity_type::input_select,
+  entity_type::number,
+  entity_type::input_number,
+  entity_type::vacuum,
+  entity_type::timer,
+  entity_type::person,
+  entity_type::service,
+
+  entity_type::cover,
+  entity_type::sensor,
+  entity_type::binary_sensor,
+  entity_type::input_text,
+  entity_type::text,
+  entity_type::select,
+  entity_type::alarm_control_panel,
+  entity_type::media_player,
+  entity_type::sun,
+  entity_type::climate,
+  entity_type::weather,
+
+  // internal (non HA) types
+  entity_type::nav_up,
+  entity_type::nav_prev,
+  entity_type::nav_next,
+  entity_type::uuid,
+  entity_type::navigate,
+  entity_type::navigate_uuid,
+  entity_type::itext,
+  entity_type::delete_,
+};
+
+inline const char *to_string(entity_kind kind) {
+  if ((size_t)kind >= (sizeof(entity_kind_names) / sizeof(*entity_kind_names)))
+    return nullptr;
+  return entity_kind_names[(uint8_t)kind];
+}
+
 struct entity_render_type {
   static constexpr const char* text = "text";
   static constexpr const char* shutter = "shutter";
@@ -459,6 +690,230 @@ struct action_type {
   static constexpr const char* startup = "startup";
 };
 
+enum class event_action : uint8_t {
+  unknown,
+  buttonPress2,
+  pageOpenDetail,
+  sleepReached,
+  startup,
+};
+
+static constexpr const char* event_action_names [] = {
+  "unknown",
+  action_type::buttonPress2,
+  action_type::pageOpenDetail,
+  action_type::sleepReached,
+  action_type::startup,
+};
+
+inline const char *to_string(event_action action) {
+  if ((size_t)action >= (sizeof(event_action_names) / sizeof(*event_action_names)))
+    return nullptr;
+  return event_action_names[(uint8_t)action];
+}
+
+// note: The lookups below switch on the hash of the value (computed at compile
+//       time for the known values) instead of comparing against every string.
+//       The hash only selects the candidate, an exact match is still required.
+inline event_action to_event_action(std::string_view action) {
+  event_action ret;
+  switch (fnv1a_hash(action)) {
+  case fnv1a_hash(action_type::buttonPress2): ret = event_action::buttonPress2; break;
+  case fnv1a_hash(action_type::pageOpenDetail): ret = event_action::pageOpenDetail; break;
+  case fnv1a_hash(action_type::sleepReached): ret = event_action::sleepReached; break;
+  case fnv1a_hash(action_type::startup): ret = event_action::startup; break;
+  default: return event_action::unknown;
+  }
+  return action == to_string(ret) ? ret : event_action::unknown;
+}
+
+enum class button_action : uint8_t {
+  unknown,
+  bExit,
+  sleepReached,
+  onOff,
+  numberSet,
+  button,
+
+  // shutters and covers
+  up,
+  stop,
+  down,
+  positionSlider,
+  tiltOpen,
+  tiltStop,
+  tiltClose,
+  tiltSlider,
+
+  // media page
+  mediaNext,
+  mediaBack,
+  mediaPause,
+  mediaOnOff,
+  mediaShuffle,
+  volumeSlider,
+  speakerSel,
+  modeMediaPlayer,
+
+  // light page
+  brightnessSlider,
+  colorTempSlider,
+  colorWheel,
+  modeLight,
+
+  // climate page
+  tempUpd,
+  tempUpdHighLow,
+  hvacAction,
+  modePresetModes,
+  modeSwingModes,
+  modeFanModes,
+
+  // alarm page
+  disarm,
+  armHome,
+  armAway,
+  armNight,
+  armVacation,
+  armCustomBypass,
+  opnSensorNotify,
+
+  // unlock page
+  cardUnlockUnlock,
+
+  // timer detail page
+  timerStart,
+  timerCancel,
+  timerPause,
+  timerFinish,
+
+  modeInputSelect,
+  modeSelect,
+};
+
+static constexpr const char* button_action_names [] = {
+  "unknown",
+  button_type::bExit,
+  button_type::sleepReached,
+  button_type::onOff,
+  button_type::numberSet,
+  button_type::button,
+
+  // shutters and covers
+  button_type::up,
+  button_type::stop,
+  button_type::down,
+  button_type::positionSlider,
+  button_type::tiltOpen,
+  button_type::tiltStop,
+  button_type::tiltClose,
+  button_type::tiltSlider,
+
+  // media page
+  button_type::mediaNext,
+  button_type::mediaBack,
+  button_type::mediaPause,
+  button_type::mediaOnOff,
+  button_type::mediaShuffle,
+  button_type::volumeSlider,
+  button_type::speakerSel,
+  button_type::modeMediaPlayer,
+
+  // light page
+  button_type::brightnessSlider,
+  button_type::colorTempSlider,
+  button_type::colorWheel,
+  button_type::modeLight,
+
+  // climate page
+  button_type::tempUpd,
+  button_type::tempUpdHighLow,
+  button_type::hvacAction,
+  button_type::modePresetModes,
+  button_type::modeSwingModes,
+  button_type::modeFanModes,
+
+  // alarm page
+  button_type::disarm,
+  button_type::armHome,
+  button_type::armAway,
+  button_type::armNight,
+  button_type::armVacation,
+  button_type::armCustomBypass,
+  button_type::opnSensorNotify,
+
+  // unlock page
+  button_type::cardUnlockUnlock,
+
+  // timer detail page
+  button_type::timerStart,
+  button_type::timerCancel,
+  button_type::timerPause,
+  button_type::timerFinish,
+
+  button_type::modeInputSelect,
+  button_type::modeSelect,
+};
+
+inline const char *to_string(button_action action) {
+  if ((size_t)action >= (sizeof(button_action_names) / sizeof(*button_action_names)))
+    return nullptr;
+  return button_action_names[(uint8_t)action];
+}
+
+inline button_action to_button_action(std::string_view type) {
+  button_action action;
+  switch (fnv1a_hash(type)) {
+  case fnv1a_hash(button_type::bExit): action = button_action::bExit; break;
+  case fnv1a_hash(button_type::sleepReached): action = button_action::sleepReached; break;
+  case fnv1a_hash(button_type::onOff): action = button_action::onOff; break;
+  case fnv1a_hash(button_type::numberSet): action = button_action::numberSet; break;
+  case fnv1a_hash(button_type::button): action = button_action::button; break;
+  case fnv1a_hash(button_type::up): action = button_action::up; break;
+  case fnv1a_hash(button_type::stop): action = button_action::stop; break;
+  case fnv1a_hash(button_type::down): action = button_action::down; break;
+  case fnv1a_hash(button_type::positionSlider): action = button_action::positionSlider; break;
+  case fnv1a_hash(button_type::tiltOpen): action = button_action::tiltOpen; break;
+  case fnv1a_hash(button_type::tiltStop): action = button_action::tiltStop; break;
+  case fnv1a_hash(button_type::tiltClose): action = button_action::tiltClose; break;
+  case fnv1a_hash(button_type::tiltSlider): action = button_action::tiltSlider; break;
+  case fnv1a_hash(button_type::mediaNext): action = button_action::mediaNext; break;
+  case fnv1a_hash(button_type::mediaBack): action = button_action::mediaBack; break;
+  case fnv1a_hash(button_type::mediaPause): action = button_action::mediaPause; break;
+  case fnv1a_hash(button_type::mediaOnOff): action = button_action::mediaOnOff; break;
+  case fnv1a_hash(button_type::mediaShuffle): action = button_action::mediaShuffle; break;
+  case fnv1a_hash(button_type::volumeSlider): action = button_action::volumeSlider; break;
+  case fnv1a_hash(button_type::speakerSel): action = button_action::speakerSel; break;
+  case fnv1a_hash(button_type::modeMediaPlayer): action = button_action::modeMediaPlayer; break;
+  case fnv1a_hash(button_type::brightnessSlider): action = button_action::brightnessSlider; break;
+  case fnv1a_hash(button_type::colorTempSlider): action = button_action::colorTempSlider; break;
+  case fnv1a_hash(button_type::colorWheel): action = button_action::colorWheel; break;
+  case fnv1a_hash(button_type::modeLight): action = button_action::modeLight; break;
+  case fnv1a_hash(button_type::tempUpd): action = button_action::tempUpd; break;
+  case fnv1a_hash(button_type::tempUpdHighLow): action = button_action::tempUpdHighLow; break;
+  case fnv1a_hash(button_type::hvacAction): action = button_action::hvacAction; break;
+  case fnv1a_hash(button_type::modePresetModes): action = button_action::modePresetModes; break;
+  case fnv1a_hash(button_type::modeSwingModes): action = button_action::modeSwingModes; break;
+  case fnv1a_hash(button_type::modeFanModes): action = button_action::modeFanModes; break;
+  case fnv1a_hash(button_type::disarm): action = button_action::disarm; break;
+  case fnv1a_hash(button_type::armHome): action = button_action::armHome; break;
+  case fnv1a_hash(button_type::armAway): action = button_action::armAway; break;
+  case fnv1a_hash(button_type::armNight): action = button_action::armNight; break;
+  case fnv1a_hash(button_type::armVacation): action = button_action::armVacation; break;
+  case fnv1a_hash(button_type::armCustomBypass): action = button_action::armCustomBypass; break;
+  case fnv1a_hash(button_type::opnSensorNotify): action = button_action::opnSensorNotify; break;
+  case fnv1a_hash(button_type::cardUnlockUnlock): action = button_action::cardUnlockUnlock; break;
+  case fnv1a_hash(button_type::timerStart): action = button_action::timerStart; break;
+  case fnv1a_hash(button_type::timerCancel): action = button_action::timerCancel; break;
+  case fnv1a_hash(button_type::timerPause): action = button_action::timerPause; break;
+  case fnv1a_hash(button_type::timerFinish): action = button_action::timerFinish; break;
+  case fnv1a_hash(button_type::modeInputSelect): action = button_action::modeInputSelect; break;
+  case fnv1a_hash(button_type::modeSelect): action = button_action::modeSelect; break;
+  default: return button_action::unknown;
+  }
+  return type == to_string(action) ? action : button_action::unknown;
+}
+
 struct ha_action_type {
   static constexpr const char* turn_on = "turn_on";
   static constexpr const char* turn_off = "turn_off";
@@ -693,10 +1148,79 @@ inline datetime_mode operator&(datetime_mode a, datetime_mode b) {
 }
 
 // note: The FrozenCharMap is designed to avoid dynamic memory allocation by
-//       making use of std::array instead of std::map
+//       making use of std::array instead of std::map.
+//       The entries must be sorted by key (see make_sorted_map) so they can
+//       be found with a binary search.
 template <typename Value, size_t Size>
 using FrozenCharMap = const std::array<std::pair<const char *, Value>, Size>;
 
+// strcmp which can be evaluated at compile time
+inline constexpr int str_compare(const char *a, const char *b) {
+  while (*a != '\0' && *a == *b) { a++; b++; }
+  return static_cast<unsigned char>(*a) - static_cast<unsigned char>(*b);
+}
+
+template<typename Value, size_t Size, size_t... I>
+constexpr std::array<std::pair<const char *, Value>, Size> make_sorted_map_(
+    const std::array<std::pair<const char *, Value>, Size> &map, std::index_sequence<I...>) {
+  // note: std::pair can't be assigned in a constexpr function (C++17),
+  //       so the indexes are sorted and the entries copied in that order
+  std::array<size_t, Size> order{};
+  for (size_t i = 0; i < Size; i++) order[i] = i;
+  for (size_t i = 1; i < Size; i++) {
+    for (size_t j = i; j > 0 && str_compare(map[order[j]].first, map[order[j - 1]].first) < 0; j--) {
+      auto tmp = order[j];
+      order[j] = order[j - 1];
+      order[j - 1] = tmp;
+    }
+  }
+  return {{ map[order[I]]... }};
+}
+
+// Returns the map sorted by key, use this to define every FrozenCharMap
+template<typename Value, size_t Size>
+constexpr std::array<std::pair<const char *, Value>, Size> make_sorted_map(
+    const std::array<std::pair<const char *, Value>, Size> &map) {
+  return make_sorted_map_(map, std::make_index_sequence<Size>{});
+}
+
+// True when the keys are sorted and unique
+template<typename Value, size_t Size>
+constexpr bool is_sorted_map(const FrozenCharMap<Value, Size> &map) {
+  for (size_t i = 1; i < Size; i++) {
+    if (str_compare(map[i - 1].first, map[i].first) >= 0) return false;
+  }
+  return true;
+}
+
+template<typename Value, size_t Size>
+inline const std::pair<const char *, Value> *find_entry(
+    const FrozenCharMap<Value, Size> &map, const char *key) {
+  size_t low = 0, high = Size;
+  while (low < high) {
+    size_t mid = (low + high) / 2;
+    int cmp = std::strcmp(map[mid].first, key);
+    if (cmp == 0) return &map[mid];
+    if (cmp < 0) low = mid + 1;
+    else high = mid;
+  }
+  return nullptr;
+}
+
+template<typename Value, size_t Size>
+inline const std::pair<const char *, Value> *find_entry(
+    const FrozenCharMap<Value, Size> &map, std::string_view key) {
+  size_t low = 0, high = Size;
+  while (low < high) {
+    size_t mid = (low + high) / 2;
+    int cmp = std::string_view(map[mid].first).compare(key);
+    if (cmp == 0) return &map[mid];
+    if (cmp < 0) low = mid + 1;
+    else high = mid;
+  }
+  return nullptr;
+}
+
 template<typename Value, size_t Size>
 inline bool try_get_value(
     const FrozenCharMap<Value, Size> &map,
@@ -708,16 +1232,14 @@ inline bool try_get_value(
 
   const char *key_cstr = key;
   do {
-    if ((key_cstr != nullptr && strlen(key_cstr) > 0)) {
-      auto it = map.begin();
-      for (; it != map.end(); ++it) {
-        if (!str_equal(it->first, key_cstr)) continue;
-        return_value = it->second;
+    if (key_cstr != nullptr && key_cstr[0] != '\0') {
+      if (auto entry = find_entry(map, key_cstr)) {
+        return_value = entry->second;
         return true;
       }
     }
     if (key_cstr == fallback_key || 
-        fallback_key == nullptr || strlen(fallback_key) == 0)
+        fallback_key == nullptr || fallback_key[0] == '\0')
       return false;
     key_cstr = fallback_key;
   } while (true);
@@ -737,27 +1259,30 @@ inline bool try_get_value(
 template<typename Value, size_t Size>
 inline const Value &get_value_or_default(
     const FrozenCharMap<Value, Size> &map,
-    const std::string &key,
+    std::string_view key,
     const Value &default_value,
     const char *fallback_key = nullptr) {
-  // todo: fix this bad implementation
-  //       use pointers and unwrap Value?
-  static Value ret{};
-  if (try_get_value(map, ret, key.c_str(), fallback_key))
-    return ret;
+  if (!key.empty()) {
+    if (auto entry = find_entry(map, key))
+      return entry->second;
+  }
+  if (fallback_key != nullptr && fallback_key[0] != '\0') {
+    if (auto entry = find_entry(map, fallback_key))
+      return entry->second;
+  }
   return default_value;
 }
 
 template<size_t Size>
 inline const char *get_icon(
     const FrozenCharMap<const char *, Size> &map,
-    const std::string &key,
+    std::string_view key,
     const char *fallback_key = nullptr) {
   return get_value_or_default(map, key, icon_t::alert_circle_outline, fallback_key);
 }
 
 // simple_type_mapping
-static constexpr FrozenCharMap<const char *, 22> ENTITY_ICON_MAP {{
+static constexpr auto ENTITY_ICON_MAP = make_sorted_map(FrozenCharMap<const char *, 22> {{
   {entity_type::button, icon_t::gesture_tap_button},
   {entity_type::navigate, icon_t::gesture_tap_button},
   {entity_type::input_button, icon_t::gesture_tap_button},
@@ -781,10 +1306,11 @@ static constexpr FrozenCharMap<const char *, 22> ENTITY_ICON_MAP {{
   {entity_type::input_text, icon_t::cursor_text}, //added
   {entity_type::text, icon_t::cursor_text}, //added
   {entity_type::select, icon_t::gesture_tap_button}, //added
-}};
+}});
+static_assert(is_sorted_map(ENTITY_ICON_MAP), "ENTITY_ICON_MAP keys must be unique");
 
 // sensor_mapping_on
-static constexpr FrozenCharMap<const char *, 27> SENSOR_ON_ICON_MAP {{
+static constexpr auto SENSOR_ON_ICON_MAP = make_sorted_map(FrozenCharMap<const char *, 27> {{
   {sensor_type::battery, icon_t::battery_outline},
   {sensor_type::battery_charging, icon_t::battery_charging},
   {sensor_type::carbon_monoxide, icon_t::smoke_detector_alert},
@@ -812,10 +1338,11 @@ static constexpr FrozenCharMap<const char *, 27> SENSOR_ON_ICON_MAP {{
   {sensor_type::update, icon_t::package_up},
   {sensor_type::vibration, icon_t::vibrate},
   {sensor_type::window, icon_t::window_open}
-}};
+}});
+static_assert(is_sorted_map(SENSOR_ON_ICON_MAP), "SENSOR_ON_ICON_MAP keys must be unique");
 
 // sensor_mapping_off
-static constexpr FrozenCharMap<const char *, 27> SENSOR_OFF_ICON_MAP {{
+static constexpr auto SENSOR_OFF_ICON_MAP = make_sorted_map(FrozenCharMap<const char *, 27> {{
   {sensor_type::battery, icon_t::battery},
   {sensor_type::battery_charging, icon_t::battery},
   {sensor_type::carbon_monoxide, icon_t::smoke_detector},
@@ -843,10 +1370,11 @@ static constexpr FrozenCharMap<const char *, 27> SENSOR_OFF_ICON_MAP {{
   {sensor_type::update, icon_t::package},
   {sensor_type::vibration, icon_t::crop_portrait},
   {sensor_type::window, icon_t::window_closed},
-}};
+}});
+static_assert(is_sorted_map(SENSOR_OFF_ICON_MAP), "SENSOR_OFF_ICON_MAP keys must be unique");
 
 // sensor_mapping
-static constexpr FrozenCharMap<const char *, 31> SENSOR_ICON_MAP {{
+static constexpr auto SENSOR_ICON_MAP = make_sorted_map(FrozenCharMap<const char *, 31> {{
   {sensor_type::apparent_power, icon_t::flash},
   {sensor_type::aqi, icon_t::smog},
   {sensor_type::battery, icon_t::battery},
@@ -878,7 +1406,8 @@ static constexpr FrozenCharMap<const char *, 31> SENSOR_ICON_MAP {{
   {sensor_type::timestamp, icon_t::calendar_clock},
   {sensor_type::volatile_organic_compounds, icon_t::smog},
   {sensor_type::voltage, icon_t::flash}
-}};
+}});
+static_assert(is_sorted_map(SENSOR_ICON_MAP), "SENSOR_ICON_MAP keys must be unique");
 
 // A map of icons and their respective color for each weather condition
 // see:
@@ -892,7 +1421,7 @@ static constexpr FrozenCharMap<const char *, 31> SENSOR_ICON_MAP {{
 //      - mdi icons: https://pictogrammers.com/library/mdi/
 //  - color lookup:
 //      - https://rgbcolorpicker.com/565
-static constexpr FrozenCharMap<Icon, 15> WEATHER_ICON_MAP {{
+static constexpr auto WEATHER_ICON_MAP = make_sorted_map(FrozenCharMap<Icon, 15> {{
   {weather_type::sunny,           {icon_t::weather_sunny, 65504u}}, // mdi:0599,#ffff00
   {weather_type::windy,           {icon_t::weather_windy, 38066u}}, // mdi:059D,#949694
   {weather_type::windy_variant,   {icon_t::weather_windy_variant, 64495u}}, // mdi:059E,#ff7d7b
@@ -908,10 +1437,11 @@ static constexpr FrozenCharMap<Icon, 15> WEATHER_ICON_MAP {{
   {weather_type::hail,            {icon_t::weather_hail, 65535u}}, // mdi:0592,#ffffff
   {weather_type::lightning,       {icon_t::weather_lightning, 65120u}}, // mdi:0593,#ffce00
   {weather_type::lightning_rainy, {icon_t::weather_lightning_rainy, 50400u}} // mdi:067E,#c59e00
-}};
+}});
+static_assert(is_sorted_map(WEATHER_ICON_MAP), "WEATHER_ICON_MAP keys must be unique");
 
 // climate_mapping
-static constexpr FrozenCharMap<const char *, 7> CLIMATE_ICON_MAP {{
+static constexpr auto CLIMATE_ICON_MAP = make_sorted_map(FrozenCharMap<const char *, 7> {{
   {entity_state::auto_, icon_t::calendar_sync},
   {entity_state::heat_cool, icon_t::calendar_sync},
   {entity_state::heat, icon_t::fire},
@@ -919,9 +1449,10 @@ static constexpr FrozenCharMap<const char *, 7> CLIMATE_ICON_MAP {{
   {entity_state::cool, icon_t::snowflake},
   {entity_state::dry, icon_t::water_percent},
   {entity_state::fan_only, icon_t::fan},
-}};
+}});
+static_assert(is_sorted_map(CLIMATE_ICON_MAP), "CLIMATE_ICON_MAP keys must be unique");
 
-static constexpr FrozenCharMap<const char *, 9> MEDIA_TYPE_ICON_MAP {{
+static constexpr auto MEDIA_TYPE_ICON_MAP = make_sorted_map(FrozenCharMap<const char *, 9> {{
   {entity_state::off, icon_t::speaker_off},
   {ha_attr_media_content_type::music, icon_t::music},
   {ha_attr_media_content_type::tvshow, icon_t::movie},
@@ -931,9 +1462,10 @@ static constexpr FrozenCharMap<const char *, 9> MEDIA_TYPE_ICON_MAP {{
   {ha_attr_media_content_type::playlist, icon_t::playlist_music}, // (originally: icon_t::alert_circle_outline)
   {ha_attr_media_content_type::app, icon_t::open_in_app}, // newly added!
   {ha_attr_media_content_type::url, icon_t::link_box_outline}, // newly added! (OR cast E117?)
-}};
+}});
+static_assert(is_sorted_map(MEDIA_TYPE_ICON_MAP), "MEDIA_TYPE_ICON_MAP keys must be unique");
 
-const FrozenCharMap<Icon, 10> ALARM_ICON_MAP {{
+static constexpr auto ALARM_ICON_MAP = make_sorted_map(FrozenCharMap<Icon, 10> {{
   {entity_state::unknown, {icon_t::shield_off, 0x0CE6u}}, //green
   {entity_state::disarmed, {icon_t::shield_off, 0x0CE6u}}, //green
   {entity_state::armed_home, {icon_t::shield_home, 0xE243u}}, //red
@@ -944,10 +1476,11 @@ const FrozenCharMap<Icon, 10> ALARM_ICON_MAP {{
   {entity_state::arming, {icon_t::shield, 0xED80u}}, //orange
   {entity_state::pending, {icon_t::shield, 0xED80u}}, //orange
   {entity_state::triggered, {icon_t::bell_ring, 0xE243u}}, //red
-}};
+}});
+static_assert(is_sorted_map(ALARM_ICON_MAP), "ALARM_ICON_MAP keys must be unique");
 
 // cover_mapping
-static constexpr FrozenCharMap<std::array<const char *, 4>, 10> COVER_MAP {{
+static constexpr auto COVER_MAP = make_sorted_map(FrozenCharMap<std::array<const char *, 4>, 10> {{
   // "device_class": ("icon-open", "icon-closed", "icon-cover-open", "icon-cover-close")
   {entity_cover_type::awning, {icon_t::window_open, icon_t::window_closed, icon_t::arrow_up, icon_t::arrow_down}},
   {entity_cover_type::blind, {icon_t::blinds_open, icon_t::blinds, icon_t::arrow_up, icon_t::arrow_down}},
@@ -959,9 +1492,10 @@ static constexpr FrozenCharMap<std::array<const char *, 4>, 10> COVER_MAP {{
   {entity_cover_type::shade, {icon_t::blinds_open, icon_t::blinds, icon_t::arrow_up, icon_t::arrow_down}},
   {entity_cover_type::shutter, {icon_t::window_shutter_open, icon_t::window_shutter, icon_t::arrow_up, icon_t::arrow_down}},
   {entity_cover_type::window, {icon_t::window_open, icon_t::window_closed, icon_t::arrow_up, icon_t::arrow_down}},
-}};
+}});
+static_assert(is_sorted_map(COVER_MAP), "COVER_MAP keys must be unique");
 
-static constexpr FrozenCharMap<const char *, 29> ENTITY_RENDER_TYPE_MAP {{
+static constexpr auto ENTITY_RENDER_TYPE_MAP = make_sorted_map(FrozenCharMap<const char *, 29> {{
   {entity_type::cover, entity_render_type::shutter},
   {entity_type::light, entity_type::light},
 
@@ -998,62 +1532,71 @@ static constexpr FrozenCharMap<const char *, 29> ENTITY_RENDER_TYPE_MAP {{
 
   {entity_type::timer, entity_type::timer},
   {entity_type::media_player, entity_render_type::media_pl},
-}};
+}});
+static_assert(is_sorted_map(ENTITY_RENDER_TYPE_MAP), "ENTITY_RENDER_TYPE_MAP keys must be unique");
+
+// Returns the kind of an entity type (domain) e.g. 'light'
+// note: The domain hashes are unique (duplicate case labels would not compile)
+//       so the switch is a perfect hash over the known domains.
+inline entity_kind to_entity_kind(std::string_view domain) {
+  entity_kind kind;
+  switch (fnv1a_hash(domain)) {
+  case fnv1a_hash(entity_type::scene): kind = entity_kind::scene; break;
+  case fnv1a_hash(entity_type::script): kind = entity_kind::script; break;
+  case fnv1a_hash(entity_type::light): kind = entity_kind::light; break;
+  case fnv1a_hash(entity_type::switch_): kind = entity_kind::switch_; break;
+  case fnv1a_hash(entity_type::input_boolean): kind = entity_kind::input_boolean; break;
+  case fnv1a_hash(entity_type::automation): kind = entity_kind::automation; break;
+  case fnv1a_hash(entity_type::fan): kind = entity_kind::fan; break;
+  case fnv1a_hash(entity_type::lock): kind = entity_kind::lock; break;
+  case fnv1a_hash(entity_type::button): kind = entity_kind::button; break;
+  case fnv1a_hash(entity_type::input_button): kind = entity_kind::input_button; break;
+  case fnv1a_hash(entity_type::input_select): kind = entity_kind::input_select; break;
+  case fnv1a_hash(entity_type::number): kind = entity_kind::number; break;
+  case fnv1a_hash(entity_type::input_number): kind = entity_kind::input_number; break;
+  case fnv1a_hash(entity_type::vacuum): kind = entity_kind::vacuum; break;
+  case fnv1a_hash(entity_type::timer): kind = entity_kind::timer; break;
+  case fnv1a_hash(entity_type::person): kind = entity_kind::person; break;
+  case fnv1a_hash(entity_type::service): kind = entity_kind::service; break;
+  case fnv1a_hash(entity_type::cover): kind = entity_kind::cover; break;
+  case fnv1a_hash(entity_type::sensor): kind = entity_kind::sensor; break;
+  case fnv1a_hash(entity_type::binary_sensor): kind = entity_kind::binary_sensor; break;
+  case fnv1a_hash(entity_type::input_text): kind = entity_kind::input_text; break;
+  case fnv1a_hash(entity_type::text): kind = entity_kind::text; break;
+  case fnv1a_hash(entity_type::select): kind = entity_kind::select; break;
+  case fnv1a_hash(entity_type::alarm_control_panel): kind = entity_kind::alarm_control_panel; break;
+  case fnv1a_hash(entity_type::media_player): kind = entity_kind::media_player; break;
+  case fnv1a_hash(entity_type::sun): kind = entity_kind::sun; break;
+  case fnv1a_hash(entity_type::climate): kind = entity_kind::climate; break;
+  case fnv1a_hash(entity_type::weather): kind = entity_kind::weather; break;
+  case fnv1a_hash(entity_type::nav_up): kind = entity_kind::nav_up; break;
+  case fnv1a_hash(entity_type::nav_prev): kind = entity_kind::nav_prev; break;
+  case fnv1a_hash(entity_type::nav_next): kind = entity_kind::nav_next; break;
+  case fnv1a_hash(entity_type::uuid): kind = entity_kind::uuid; break;
+  case fnv1a_hash(entity_type::navigate): kind = entity_kind::navigate; break;
+  case fnv1a_hash(entity_type::itext): kind = entity_kind::itext; break;
+  default: return entity_kind::unknown;
+  }
+  return domain == to_string(kind) ? kind : entity_kind::unknown;
+}
 
-inline const char *get_entity_type(const std::string &entity_id) {
+inline entity_kind get_entity_kind(std::string_view entity_id) {
   auto pos = entity_id.find('.');
-  if (pos == std::string::npos) {
-    if (entity_id == entity_type::delete_)
-      return entity_type::delete_;
-    return nullptr;
+  if (pos == std::string_view::npos) {
+    return entity_id == entity_type::delete_ ? entity_kind::delete_ : entity_kind::unknown;
   }
-  
-	auto type = entity_id.substr(0, pos);
-
-	if (type == entity_type::light) return entity_type::light;
-  else if (type == entity_type::switch_) return entity_type::switch_;
-  else if (type == entity_type::input_boolean) return entity_type::input_boolean;
-  else if (type == entity_type::automation) return entity_type::automation;
-  else if (type == entity_type::fan) return entity_type::fan;
-  else if (type == entity_type::lock) return entity_type::lock;
-  else if (type == entity_type::button) return entity_type::button;
-  else if (type == entity_type::input_button) return entity_type::input_button;
-  else if (type == entity_type::input_select) return entity_type::input_select;
-  else if (type == entity_type::number) return entity_type::number;
-  else if (type == entity_type::input_number) return entity_type::input_number;
-  else if (type == entity_type::vacuum) return entity_type::vacuum;
-  else if (type == entity_type::timer) return entity_type::timer;
-  else if (type == entity_type::person) return entity_type::person;
-  else if (type == entity_type::service) return entity_type::service;
-  else if (type == entity_type::scene) return entity_type::scene;
-  else if (type == entity_type::script) return entity_type::script;
-
-  else if (type == entity_type::cover) return entity_type::cover;
-  else if (type == entity_type::sensor) return entity_type::sensor;
-  else if (type == entity_type::binary_sensor) return entity_type::binary_sensor;
-  else if (type == entity_type::text) return entity_type::text;
-  else if (type == entity_type::input_text) return entity_type::input_text;
-  else if (type == entity_type::select) return entity_type::select;
-  else if (type == entity_type::alarm_control_panel) return entity_type::alarm_control_panel;
-  else if (type == entity_type::media_player) return entity_type::media_player;
-  else if (type == entity_type::sun) return entity_type::sun;
-  else if (type == entity_type::climate) return entity_type::climate;
-  else if (type == entity_type::weather) return entity_type::weather;
 
-  // internal (non HA) types
-  else if (type == entity_type::nav_up) return entity_type::nav_up;
-  else if (type == entity_type::nav_prev) return entity_type::nav_prev;
-  else if (type == entity_type::nav_next) return entity_type::nav_next;
-  else if (type == entity_type::uuid) return entity_type::uuid;
-  else if (type == entity_type::navigate) {
-    if (entity_id.length() > (pos + 5) &&
-      entity_id.substr(0, pos + 5) == entity_type::navigate_uuid)
-      return entity_type::navigate_uuid;
-    return entity_type::navigate;
+  auto kind = to_entity_kind(entity_id.substr(0, pos));
+  if (kind == entity_kind::navigate) {
+    constexpr std::string_view prefix(entity_type::navigate_uuid);
+    if (entity_id.size() > prefix.size() && entity_id.substr(0, prefix.size()) == prefix)
+      return entity_kind::navigate_uuid;
   }
-  else if (type == entity_type::itext) return entity_type::itext;
-  
-  else return nullptr;
+  return kind;
+}
+
+inline const char *get_entity_type(std::string_view entity_id) {
+  return to_string(get_entity_kind(entity_id));
 }
 
 } // namespace nspanel_lovelace
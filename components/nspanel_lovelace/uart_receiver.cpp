@@ -0,0 +1,190 @@
+#include "uart_receiver.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#ifdef USE_ESP_IDF
+#include <driver/uart.h>
+#include <freertos/queue.h>
+#include "esphome/components/uart/uart_component_esp_idf.h"
+#endif
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+static const char *const TAG = "nspanel_lovelace";
+
+UartReceiver::~UartReceiver() {
+  this->stop();
+#ifdef USE_ESP32
+  if (this->stopped_ != nullptr) vSemaphoreDelete(this->stopped_);
+#endif
+}
+
+bool UartReceiver::start(uart::UARTComponent *uart) {
+  if (this->running_) return true;
+  this->uart_ = uart;
+  this->stop_ = false;
+  this->parser_.reset();
+#ifdef USE_ESP32
+  if (this->stopped_ == nullptr) this->stopped_ = xSemaphoreCreateBinary();
+  if (this->stopped_ == nullptr) {
+    ESP_LOGE(TAG, "Failed to start the UART receive task");
+    return false;
+  }
+  // the task must not be starved by loop(), so it runs on the other core
+  const BaseType_t core = xPortGetCoreID() == 0 ? 1 : 0;
+  if (xTaskCreatePinnedToCore(UartReceiver::task_, "nspanel_uart_rx",
+      UART_RX_TASK_STACK_SIZE, this, UART_RX_TASK_PRIORITY,
+      &this->task_handle_, core) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start the UART receive task");
+    return false;
+  }
+#else
+  this->thread_ = std::thread([this]() { this->run_(); });
+#endif
+  this->running_ = true;
+  return true;
+}
+
+void UartReceiver::stop() {
+  if (!this->running_) return;
+  this->stop_ = true;
+#ifdef USE_ESP32
+  // the parser and the queue are destroyed with the receiver, so wait until
+  // the task is done with them (it notices stop_ after the next wait)
+  xSemaphoreTake(this->stopped_, portMAX_DELAY);
+  vTaskDelete(this->task_handle_);
+  this->task_handle_ = nullptr;
+#else
+  this->thread_.join();
+#endif
+  this->running_ = false;
+}
+
+void UartReceiver::pause() {
+  // note: the task reads the sequence before checking paused_, so it can only
+  //       acknowledge this sequence after seeing this pause (not an earlier one)
+  const uint32_t sequence = ++this->pause_sequence_;
+  this->paused_ = true;
+  if (!this->running_) return;
+  while (this->paused_ack_ != sequence) {
+#ifdef USE_ESP32
+    vTaskDelay(1);
+#else
+    std::this_thread::yield();
+#endif
+  }
+}
+
+void UartReceiver::resume() { this->paused_ = false; }
+
+bool UartReceiver::pop(uart_rx_message &message) {
+  if (!this->messages_.pop(message)) return false;
+  const uint32_t latency = millis() - message.received_at;
+  this->stats_.received++;
+  this->stats_.total_latency_ms += latency;
+  this->stats_.max_latency_ms = std::max(this->stats_.max_latency_ms, latency);
+  return true;
+}
+
+void UartReceiver::run_() {
+  bool paused = false;
+  while (!this->stop_) {
+    const uint32_t sequence = this->pause_sequence_;
+    if (this->paused_) {
+      this->paused_ack_ = sequence;
+      paused = true;
+#ifdef USE_ESP32
+      vTaskDelay(pdMS_TO_TICKS(10));
+#else
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+#endif
+      continue;
+    }
+    if (paused) {
+      // anything received while paused wasn't meant for us
+      this->parser_.reset();
+      paused = false;
+    }
+    this->read_();
+    this->wait_();
+  }
+}
+
+void UartReceiver::read_() {
+  auto &buffer = this->parser_.get_buffer();
+  int available;
+  while ((available = this->uart_->available()) > 0) {
+    size_t len;
+    uint8_t *data = buffer.write_region(len);
+    if (len == 0) break;
+    len = std::min(len, static_cast<size_t>(available));
+    if (!this->uart_->read_array(data, len)) break;
+    buffer.commit(len);
+
+    frame_result result;
+    while ((result = this->parser_.parse()) != frame_result::incomplete) {
+      switch (result) {
+      case frame_result::frame:
+        this->queue_(result, this->parser_.get_payload(), this->parser_.get_payload_length());
+        break;
+      case frame_result::invalid:
+        this->queue_(result, this->parser_.get_discarded_data(), this->parser_.get_discarded_length());
+        break;
+      default:
+        this->queue_(result, nullptr, 0);
+        break;
+      }
+    }
+  }
+}
+
+void UartReceiver::queue_(frame_result result, const uint8_t *data, size_t len) {
+  auto &message = this->message_;
+  // every frame fits, discarded data is only logged so it is truncated
+  len = std::min(len, message.data.size());
+  message.result = result;
+  message.length = static_cast<uint16_t>(len);
+  message.received_at = millis();
+  if (len > 0) std::memcpy(message.data.data(), data, len);
+  if (!this->messages_.push(message)) this->dropped_count_++;
+}
+
+#ifdef USE_ESP32
+void UartReceiver::task_(void *arg) {
+  auto *receiver = static_cast<UartReceiver *>(arg);
+  receiver->run_();
+  xSemaphoreGive(receiver->stopped_);
+  // stop() deletes the task once it has seen the semaphore
+  vTaskSuspend(nullptr);
+}
+#endif
+
+void UartReceiver::wait_() {
+#if defined(USE_ESP32) && defined(USE_ESP_IDF)
+  // hopefully on NSPanel it should always be an IDFUARTComponent instance
+  auto *uart = reinterpret_cast<uart::IDFUARTComponent*>(this->uart_);
+  uart_event_t event;
+  // the timeout makes sure stop() and pause() are noticed
+  if (xQueueReceive(*uart->get_uart_event_queue(), &event,
+      pdMS_TO_TICKS(UART_RX_TASK_TIMEOUT_MS)) != pdTRUE)
+    return;
+  if (event.type == UART_FIFO_OVF || event.type == UART_BUFFER_FULL) {
+    // the data is incomplete, start again from the next frame
+    uart_flush_input(uart->get_hw_serial_number());
+    this->parser_.reset();
+    this->overflow_count_++;
+  }
+#elif defined(USE_ESP32)
+  vTaskDelay(1);
+#else
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+}
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esphome/core/defines.h"
+#include "esphome/components/uart/uart.h"
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#endif
+
+#include "config.h"
+#include "frame_parser.h"
+#include "spsc_queue.h"
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+// Largest frame payload the UART receive task can queue (bytes),
+// every frame the parser accepts must fit
+constexpr size_t UART_RX_TASK_MESSAGE_SIZE = FRAME_MAX_PAYLOAD_SIZE;
+
+struct uart_rx_message {
+  frame_result result;
+  uint16_t length;
+  // millis() when the message was received
+  uint32_t received_at;
+  // the frame payload (or discarded data)
+  std::array<uint8_t, UART_RX_TASK_MESSAGE_SIZE> data;
+};
+
+struct uart_rx_stats {
+  uint32_t received = 0;
+  // time from the message being received to loop() taking it from the queue
+  uint32_t total_latency_ms = 0;
+  uint32_t max_latency_ms = 0;
+};
+
+/**
+ * Receives data from the display on a separate task, so the input latency
+ * doesn't depend on how often loop() is called.
+ *
+ * The task waits for UART events (ESP-IDF) or polls the UART every tick,
+ * then frames and CRC checks the data with its own FrameParser. Complete
+ * messages are passed to loop() through a lock-free queue.
+ */
+class UartReceiver {
+public:
+  ~UartReceiver();
+
+  bool start(uart::UARTComponent *uart);
+  void stop();
+  bool is_running() const { return this->running_; }
+  // Stops reading from the UART (i.e. while a TFT file is uploaded),
+  // returns once the task has stopped reading
+  void pause();
+  void resume();
+
+  // Must only be called from loop()
+  bool pop(uart_rx_message &message);
+  const uart_rx_stats &get_stats() const { return this->stats_; }
+
+  // Messages lost because the queue was full
+  uint32_t get_dropped_count() const { return this->dropped_count_; }
+  // Number of times the UART receive buffer overflowed
+  uint32_t get_overflow_count() const { return this->overflow_count_; }
+
+protected:
+  void run_();
+  // Parses everything available from the UART
+  void read_();
+  void queue_(frame_result result, const uint8_t *data, size_t len);
+  // Waits for more data to arrive
+  void wait_();
+
+  uart::UARTComponent *uart_ = nullptr;
+  FrameParser parser_;
+  SpscQueue<uart_rx_message, UART_RX_TASK_QUEUE_SIZE> messages_;
+  // only used by the task
+  uart_rx_message message_;
+  // only used by loop()
+  uart_rx_stats stats_;
+  bool running_ = false;
+  std::atomic<bool> stop_{false};
+  std::atomic<bool> paused_{false};
+  // incremented by every pause() call
+  std::atomic<uint32_t> pause_sequence_{0};
+  // the pause_sequence_ seen by the task once it has stopped reading
+  std::atomic<uint32_t> paused_ack_{0};
+  std::atomic<uint32_t> dropped_count_{0};
+  std::atomic<uint32_t> overflow_count_{0};
+
+#ifdef USE_ESP32
+  static void task_(void *arg);
+  TaskHandle_t task_handle_ = nullptr;
+  // given by the task once it has stopped using the parser and the queue
+  SemaphoreHandle_t stopped_ = nullptr;
+#else
+  std::thread thread_;
+#endif
+};
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "worker.h"
+
+#include <algorithm>
+
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+static const char *const TAG = "nspanel_lovelace";
+
+Worker::~Worker() {
+  this->stop();
+  WorkerJob *job;
+  while (this->jobs_.pop(job)) delete job;
+  while (this->results_.pop(job)) delete job;
+#ifdef USE_ESP32
+  if (this->stopped_ != nullptr) vSemaphoreDelete(this->stopped_);
+#endif
+}
+
+bool Worker::start() {
+  if (this->running_) return true;
+  this->stop_ = false;
+#ifdef USE_ESP32
+  if (this->stopped_ == nullptr) this->stopped_ = xSemaphoreCreateBinary();
+  if (this->stopped_ == nullptr) {
+    ESP_LOGE(TAG, "Failed to start the worker task");
+    return false;
+  }
+  // loop() runs on one core, so use the other one
+  const BaseType_t core = xPortGetCoreID() == 0 ? 1 : 0;
+  if (xTaskCreatePinnedToCore(Worker::task_, "nspanel_worker",
+      WORKER_TASK_STACK_SIZE, this, WORKER_TASK_PRIORITY,
+      &this->task_handle_, core) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start the worker task");
+    return false;
+  }
+#else
+  this->thread_ = std::thread([this]() { this->run_(); });
+#endif
+  this->running_ = true;
+  return true;
+}
+
+void Worker::stop() {
+  if (!this->running_) return;
+  this->stop_ = true;
+  this->notify_();
+#ifdef USE_ESP32
+  // the queues are destroyed with the worker, so wait until the task is done with them
+  xSemaphoreTake(this->stopped_, portMAX_DELAY);
+  vTaskDelete(this->task_handle_);
+  this->task_handle_ = nullptr;
+#else
+  this->thread_.join();
+#endif
+  this->running_ = false;
+}
+
+void Worker::submit(std::unique_ptr<WorkerJob> job) {
+  if (!this->running_) {
+    job->run();
+    job->complete();
+    this->completed_count_++;
+    return;
+  }
+
+  WorkerJob *ptr = job.release();
+  while (!this->jobs_.push(ptr)) {
+    // complete the jobs which are done so the worker isn't blocked by the result queue
+    this->loop();
+    yield_();
+  }
+  this->pending_++;
+  this->max_pending_ = std::max(this->max_pending_, this->pending_);
+  this->notify_();
+}
+
+void Worker::loop() {
+  WorkerJob *job;
+  while (this->results_.pop(job)) {
+    job->complete();
+    delete job;
+    this->pending_--;
+    this->completed_count_++;
+  }
+}
+
+void Worker::run_() {
+  while (!this->stop_) {
+    WorkerJob *job;
+    if (!this->jobs_.pop(job)) {
+      this->wait_for_jobs_();
+      continue;
+    }
+    job->run();
+    while (!this->results_.push(job)) {
+      if (this->stop_) {
+        delete job;
+        return;
+      }
+      yield_();
+    }
+  }
+}
+
+#ifdef USE_ESP32
+void Worker::task_(void *arg) {
+  auto *worker = static_cast<Worker *>(arg);
+  worker->run_();
+  xSemaphoreGive(worker->stopped_);
+  // stop() deletes the task, so notify_() never uses a deleted task handle
+  vTaskSuspend(nullptr);
+}
+
+void Worker::wait_for_jobs_() {
+  // notifications are counted so a job submitted before waiting isn't missed
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+void Worker::notify_() {
+  if (this->task_handle_ != nullptr) xTaskNotifyGive(this->task_handle_);
+}
+
+void Worker::yield_() { vTaskDelay(1); }
+#else
+void Worker::wait_for_jobs_() {
+  std::unique_lock<std::mutex> lock(this->mutex_);
+  this->wake_.wait(lock, [this]() { return this->stop_ || !this->jobs_.empty(); });
+}
+
+void Worker::notify_() {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  this->wake_.notify_one();
+}
+
+void Worker::yield_() { std::this_thread::yield(); }
+#endif
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
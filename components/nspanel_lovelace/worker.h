@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#include "config.h"
+#include "spsc_queue.h"
+
+namespace esphome {
+namespace nspanel_lovelace {
+
+// A unit of work which is done off the main loop
+class WorkerJob {
+public:
+  virtual ~WorkerJob() = default;
+  // Runs on the worker task, so it must not use anything loop() can change
+  virtual void run() = 0;
+  // Runs in loop() once run() has finished
+  virtual void complete() = 0;
+};
+
+template<typename State, typename Run, typename Complete>
+class LambdaWorkerJob : public WorkerJob {
+public:
+  LambdaWorkerJob(State &&state, Run &&run, Complete &&complete) :
+      state_(std::move(state)), run_(std::move(run)), complete_(std::move(complete)) {}
+  void run() override { this->run_(this->state_); }
+  void complete() override { this->complete_(this->state_); }
+
+protected:
+  State state_;
+  Run run_;
+  Complete complete_;
+};
+
+// Creates a job where run and complete are passed the state owned by the job
+template<typename State, typename Run, typename Complete>
+std::unique_ptr<WorkerJob> make_worker_job(State state, Run run, Complete complete) {
+  return std::unique_ptr<WorkerJob>(new LambdaWorkerJob<State, Run, Complete>(
+    std::move(state), std::move(run), std::move(complete)));
+}
+
+/**
+ * Runs CPU heavy jobs on a separate task (pinned to the other core on the ESP32,
+ * a std::thread elsewhere).
+ *
+ * Jobs are passed to the task and back to loop() through lock-free queues,
+ * so they are completed in the order they were submitted. When the worker
+ * isn't running jobs are run and completed immediately by submit().
+ */
+class Worker {
+public:
+  ~Worker();
+
+  bool start();
+  void stop();
+  bool is_running() const { return this->running_; }
+
+  // Takes ownership of the job. Waits for the worker to catch up when the queue is full.
+  void submit(std::unique_ptr<WorkerJob> job);
+  // Completes the finished jobs, must be called from loop()
+  void loop();
+  // True until every submitted job has been completed
+  bool is_busy() const { return this->pending_ > 0; }
+
+  uint32_t get_completed_count() const { return this->completed_count_; }
+  size_t get_max_pending() const { return this->max_pending_; }
+
+protected:
+  static constexpr size_t QUEUE_SIZE = WORKER_QUEUE_SIZE;
+
+  void run_();
+  void wait_for_jobs_();
+  void notify_();
+  static void yield_();
+
+  SpscQueue<WorkerJob *, QUEUE_SIZE> jobs_;
+  SpscQueue<WorkerJob *, QUEUE_SIZE> results_;
+  bool running_ = false;
+  std::atomic<bool> stop_{false};
+  // number of jobs submitted but not completed yet (only used by loop())
+  size_t pending_ = 0;
+  size_t max_pending_ = 0;
+  uint32_t completed_count_ = 0;
+
+#ifdef USE_ESP32
+  static void task_(void *arg);
+  TaskHandle_t task_handle_ = nullptr;
+  // given by the task once it has stopped using the queues
+  SemaphoreHandle_t stopped_ = nullptr;
+#else
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+#endif
+};
+
+} // namespace nspanel_lovelace
+} // namespace esphome
\ No newline at end of file
@@ -0,0 +1,13 @@
+#include "esphome/core/hal.h"
+
+#include <chrono>
+
+namespace esphome {
+
+uint32_t millis() {
+  static const auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace esphome
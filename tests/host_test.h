@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal assertions for the host tests, main() returns host_test_failures
+static int host_test_failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      host_test_failures++; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
@@ -0,0 +1,14 @@
+#pragma once
+
+// Host replacement for the ESP-IDF heap capabilities API
+#include <stddef.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_SPIRAM 1
+#define MALLOC_CAP_INTERNAL 2
+#define MALLOC_CAP_8BIT 4
+
+inline size_t heap_caps_get_free_size(int) { return 0; }
+inline size_t heap_caps_get_total_size(int) { return 0; }
+inline void *heap_caps_malloc(size_t size, int) { return malloc(size); }
+inline void heap_caps_free(void *ptr) { free(ptr); }
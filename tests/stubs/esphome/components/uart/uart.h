@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esphome {
+namespace uart {
+// Only the part of the UART component used by the tested code, tests override it
+class UARTComponent {
+public:
+  virtual ~UARTComponent() = default;
+  virtual void write_array(const uint8_t *data, size_t len) {}
+  virtual bool read_array(uint8_t *data, size_t len) { return false; }
+  virtual int available() { return 0; }
+  virtual void flush() {}
+};
+} // namespace uart
+} // namespace esphome
@@ -0,0 +1,3 @@
+#pragma once
+
+// Host builds don't define USE_ESP32, so the std::thread code paths are used
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace esphome {
+// defined by host_hal.cpp
+uint32_t millis();
+} // namespace esphome
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esphome/core/hal.h"
+
+namespace esphome {
+constexpr uint16_t encode_uint16(uint8_t msb, uint8_t lsb) {
+  return (static_cast<uint16_t>(msb) << 8) | lsb;
+}
+} // namespace esphome
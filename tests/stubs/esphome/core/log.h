@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdio>
+
+// Only warnings and errors are printed by the host tests
+#define ESP_LOGE(tag, ...) ((void)(tag), fprintf(stderr, __VA_ARGS__), fputc('\n', stderr))
+#define ESP_LOGW(tag, ...) ((void)(tag), fprintf(stderr, __VA_ARGS__), fputc('\n', stderr))
+#define ESP_LOGI(tag, ...) ((void)(tag))
+#define ESP_LOGD(tag, ...) ((void)(tag))
+#define ESP_LOGV(tag, ...) ((void)(tag))
+#define ESP_LOGVV(tag, ...) ((void)(tag))
+#define ESP_LOGCONFIG(tag, ...) ((void)(tag))
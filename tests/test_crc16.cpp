@@ -0,0 +1,106 @@
+// Checks the table driven CRC16 against the bitwise version used before,
+// whole and fed in pieces, then compares how long they take.
+//
+//   test_crc16 [--megabytes N]
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "crc16.h"
+#include "host_test.h"
+
+using namespace esphome::nspanel_lovelace;
+
+// The same as esphome::crc16() with its default arguments
+static uint16_t bitwise_crc16(const uint8_t *data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t i = 0; i < 8; i++) crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+  }
+  return crc;
+}
+
+int main(int argc, char **argv) {
+  double megabytes = 16;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--megabytes") == 0) megabytes = std::atof(argv[i + 1]);
+  }
+
+  // CRC-16/MODBUS check value
+  const std::string check = "123456789";
+  CHECK_EQ(Crc16::calculate(reinterpret_cast<const uint8_t *>(check.data()), check.size()), 0x4B37);
+  CHECK_EQ(Crc16::calculate(nullptr, 0), Crc16::INITIAL_VALUE);
+
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<uint8_t> data(600);
+  for (auto &b : data) b = byte(rng);
+
+  // every length, so each number of bytes left over after the 4 byte steps is covered
+  size_t mismatches = 0;
+  for (size_t len = 0; len <= data.size(); len++) {
+    if (Crc16::calculate(data.data(), len) != bitwise_crc16(data.data(), len)) mismatches++;
+  }
+  // split in two at every position, as when the header and the body are added separately
+  const uint16_t expected = bitwise_crc16(data.data(), data.size());
+  for (size_t split = 0; split <= data.size(); split++) {
+    Crc16 crc;
+    crc.update(data.data(), split);
+    crc.update(data.data() + split, data.size() - split);
+    if (crc.value() != expected) mismatches++;
+  }
+  // random pieces, single bytes and strings mixed
+  for (int round = 0; round < 200; round++) {
+    Crc16 crc;
+    size_t at = 0;
+    while (at < data.size()) {
+      const size_t len = std::min<size_t>(std::uniform_int_distribution<size_t>(0, 9)(rng), data.size() - at);
+      if (len == 1) {
+        crc.update(data[at]);
+      } else if (len % 2 == 0) {
+        crc.update(std::string(data.begin() + at, data.begin() + at + len));
+      } else {
+        crc.update(&data[at], len);
+      }
+      at += len;
+    }
+    if (crc.value() != expected) mismatches++;
+    crc.reset();
+    CHECK_EQ(crc.value(), Crc16::INITIAL_VALUE);
+  }
+  std::printf("mismatches with the bitwise crc16: %zu\n", mismatches);
+  CHECK_EQ(mismatches, 0u);
+
+  // a typical entityUpd payload for cardEntities
+  std::vector<uint8_t> payload(480);
+  for (auto &b : payload) b = byte(rng);
+  const size_t rounds = std::max<size_t>(1, megabytes * 1e6 / payload.size());
+  using clock = std::chrono::steady_clock;
+  auto report = [&](const char *name, clock::duration elapsed) {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    std::printf("  %-8s %8.1f MB/s %8.1f ns/frame\n", name,
+      rounds * payload.size() / seconds / 1e6, seconds * 1e9 / rounds);
+  };
+  std::printf("crc16 of %zu frames of %zu bytes:\n", rounds, payload.size());
+  // the result is used, so the loops can't be optimised away
+  uint16_t sum = 0;
+  auto start = clock::now();
+  for (size_t i = 0; i < rounds; i++) {
+    payload[0] = i;
+    sum += bitwise_crc16(payload.data(), payload.size());
+  }
+  report("bitwise", clock::now() - start);
+  start = clock::now();
+  for (size_t i = 0; i < rounds; i++) {
+    payload[0] = i;
+    sum -= Crc16::calculate(payload.data(), payload.size());
+  }
+  report("table", clock::now() - start);
+  CHECK_EQ(sum, 0);
+
+  return host_test_failures;
+}
\ No newline at end of file
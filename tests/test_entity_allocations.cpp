@@ -0,0 +1,83 @@
+// Counts the allocations made when HA values are stored in an Entity.
+// The API server hands every subscription callback its own copy of the value,
+// which must be moved into its storage instead of being copied again.
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "entity.h"
+#include "host_test.h"
+
+using namespace esphome::nspanel_lovelace;
+
+static bool counting = false;
+static size_t allocations = 0;
+static size_t allocated_bytes = 0;
+
+void *operator new(size_t size) {
+  if (counting) {
+    allocations++;
+    allocated_bytes += size;
+  }
+  if (void *ptr = std::malloc(size)) return ptr;
+  throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+struct allocation_count {
+  size_t allocations;
+  size_t bytes;
+};
+
+// Only counts what happens after the value has been handed over
+template<typename F> static allocation_count deliver(const std::string &value, F &&store) {
+  std::string copy(value);
+  allocations = allocated_bytes = 0;
+  counting = true;
+  store(std::move(copy));
+  counting = false;
+  return {allocations, allocated_bytes};
+}
+
+static void report(const char *name, allocation_count count) {
+  std::printf("%-28s %2zu allocs, %5zu B\n", name, count.allocations, count.bytes);
+}
+
+int main() {
+  Entity sensor("sensor.outside_temperature");
+  Entity weather("weather.home");
+
+  allocation_count states{};
+  for (auto state : {"a free text state that is long", "another long free text state value"}) {
+    auto count = deliver(state, [&](std::string value) { sensor.set_state(std::move(value)); });
+    states.allocations += count.allocations;
+    states.bytes += count.bytes;
+  }
+  report("2 free text states", states);
+  CHECK_EQ(states.allocations, 0u);
+  CHECK_EQ(sensor.get_state(), "another long free text state value");
+
+  allocation_count attributes = deliver("temperature", [&](std::string value) {
+    sensor.set_attribute(ha_attr_type::device_class, std::move(value));
+  });
+  auto unit = deliver("a long unit of measurement", [&](std::string value) {
+    sensor.set_attribute(ha_attr_type::unit_of_measurement, std::move(value));
+  });
+  attributes.allocations += unit.allocations;
+  attributes.bytes += unit.bytes;
+  report("2 new attributes", attributes);
+  // only the attribute vector makes room for the new values
+  CHECK(attributes.bytes < 128);
+  CHECK_EQ(sensor.get_attribute(ha_attr_type::unit_of_measurement), "a long unit of measurement");
+
+  const std::string forecast(6000, 'x');
+  auto large = deliver(forecast, [&](std::string value) {
+    weather.set_attribute(ha_attr_type::forecast, std::move(value));
+  });
+  report("6 KB forecast attribute", large);
+  CHECK(large.bytes < forecast.size());
+  CHECK_EQ(weather.get_attribute(ha_attr_type::forecast).size(), forecast.size());
+
+  return host_test_failures;
+}
\ No newline at end of file
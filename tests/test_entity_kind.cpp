@@ -0,0 +1,127 @@
+// Checks the entity kind hash switch against the chained string comparisons
+// it replaced for every domain, then compares how long they take.
+//
+//   test_entity_kind [--lookups N]
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "host_test.h"
+#include "types.h"
+
+using namespace esphome::nspanel_lovelace;
+
+// get_entity_type() before user-014
+static const char *chained_entity_type(const std::string &entity_id) {
+  auto pos = entity_id.find('.');
+  if (pos == std::string::npos) {
+    if (entity_id == entity_type::delete_) return entity_type::delete_;
+    return nullptr;
+  }
+  auto type = entity_id.substr(0, pos);
+  if (type == entity_type::light) return entity_type::light;
+  else if (type == entity_type::switch_) return entity_type::switch_;
+  else if (type == entity_type::input_boolean) return entity_type::input_boolean;
+  else if (type == entity_type::automation) return entity_type::automation;
+  else if (type == entity_type::fan) return entity_type::fan;
+  else if (type == entity_type::lock) return entity_type::lock;
+  else if (type == entity_type::button) return entity_type::button;
+  else if (type == entity_type::input_button) return entity_type::input_button;
+  else if (type == entity_type::input_select) return entity_type::input_select;
+  else if (type == entity_type::number) return entity_type::number;
+  else if (type == entity_type::input_number) return entity_type::input_number;
+  else if (type == entity_type::vacuum) return entity_type::vacuum;
+  else if (type == entity_type::timer) return entity_type::timer;
+  else if (type == entity_type::person) return entity_type::person;
+  else if (type == entity_type::service) return entity_type::service;
+  else if (type == entity_type::scene) return entity_type::scene;
+  else if (type == entity_type::script) return entity_type::script;
+  else if (type == entity_type::cover) return entity_type::cover;
+  else if (type == entity_type::sensor) return entity_type::sensor;
+  else if (type == entity_type::binary_sensor) return entity_type::binary_sensor;
+  else if (type == entity_type::text) return entity_type::text;
+  else if (type == entity_type::input_text) return entity_type::input_text;
+  else if (type == entity_type::select) return entity_type::select;
+  else if (type == entity_type::alarm_control_panel) return entity_type::alarm_control_panel;
+  else if (type == entity_type::media_player) return entity_type::media_player;
+  else if (type == entity_type::sun) return entity_type::sun;
+  else if (type == entity_type::climate) return entity_type::climate;
+  else if (type == entity_type::weather) return entity_type::weather;
+  else if (type == entity_type::nav_up) return entity_type::nav_up;
+  else if (type == entity_type::nav_prev) return entity_type::nav_prev;
+  else if (type == entity_type::nav_next) return entity_type::nav_next;
+  else if (type == entity_type::uuid) return entity_type::uuid;
+  else if (type == entity_type::navigate) {
+    if (entity_id.length() > (pos + 5) && entity_id.substr(0, pos + 5) == entity_type::navigate_uuid)
+      return entity_type::navigate_uuid;
+    return entity_type::navigate;
+  }
+  else if (type == entity_type::itext) return entity_type::itext;
+  return nullptr;
+}
+
+static bool same_type(const char *a, const char *b) {
+  return a == b || (a != nullptr && b != nullptr && std::strcmp(a, b) == 0);
+}
+
+int main(int argc, char **argv) {
+  size_t lookups = 1000000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--lookups") == 0) lookups = std::strtoul(argv[i + 1], nullptr, 10);
+  }
+
+  // an entity id for every kind
+  std::vector<std::string> ids;
+  const size_t kinds = sizeof(entity_kind_names) / sizeof(*entity_kind_names);
+  for (size_t i = 1; i < kinds; i++) {
+    const auto kind = static_cast<entity_kind>(i);
+    std::string id;
+    if (kind == entity_kind::delete_) {
+      id = entity_type::delete_;
+    } else if (kind == entity_kind::navigate_uuid) {
+      id = std::string(entity_type::navigate_uuid) + ".12";
+    } else {
+      id = std::string(to_string(kind)) + ".living_room";
+    }
+    if (get_entity_kind(id) != kind) {
+      std::fprintf(stderr, "%s: wrong kind %s\n", id.c_str(), to_string(get_entity_kind(id)));
+      host_test_failures++;
+    }
+    ids.push_back(id);
+  }
+  std::printf("entity kinds checked: %zu\n", ids.size());
+
+  // "n_xwhba" has the same hash as "input_button"
+  static_assert(fnv1a_hash("n_xwhba") == fnv1a_hash(entity_type::input_button), "not a collision");
+  const std::vector<std::string> unknown = {
+    "", ".", "light", "light_", "lights.kitchen", "Light.kitchen", ".kitchen", "n_xwhba.kitchen",
+    "deleted", "sensor"};
+  for (auto &id : unknown) CHECK(get_entity_kind(id) == entity_kind::unknown);
+  // a navigate.uuid id needs something after the prefix
+  CHECK(get_entity_kind("navigate.uuid") == entity_kind::navigate);
+  CHECK(get_entity_kind("navigate.page") == entity_kind::navigate);
+
+  // the same results as before for all of them
+  size_t mismatches = 0;
+  for (auto &id : ids) mismatches += !same_type(get_entity_type(id), chained_entity_type(id));
+  for (auto &id : unknown) mismatches += !same_type(get_entity_type(id), chained_entity_type(id));
+  for (auto id : {"navigate.uuid", "navigate.page"}) mismatches += !same_type(get_entity_type(id), chained_entity_type(id));
+  std::printf("mismatches with the chained comparisons: %zu\n", mismatches);
+  CHECK_EQ(mismatches, 0u);
+
+  using clock = std::chrono::steady_clock;
+  auto time = [&](auto &&classify) {
+    size_t found = 0;
+    auto start = clock::now();
+    for (size_t i = 0; i < lookups; i++) found += classify(ids[i % ids.size()]) != nullptr;
+    CHECK_EQ(found, lookups);
+    return std::chrono::duration<double, std::nano>(clock::now() - start).count() / lookups;
+  };
+  std::printf("%zu lookups over all %zu kinds (ns/lookup):\n", lookups, ids.size());
+  std::printf("  chained %6.1f\n", time([](const std::string &id) { return chained_entity_type(id); }));
+  std::printf("  hash    %6.1f\n", time([](const std::string &id) { return get_entity_type(id); }));
+
+  return host_test_failures;
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+// Replays the attribute updates HA sends when it (re)connects and counts the
+// notifications reaching the page items, each of which would cause a render,
+// and the updates reported as changed, each of which would schedule an update
+// of the current page (see NSPanelLovelace::on_entity_update_).
+#include <string>
+#include <vector>
+
+#include "entity.h"
+#include "host_test.h"
+
+using namespace esphome::nspanel_lovelace;
+
+struct NotificationCounter : IEntitySubscriber {
+  int notifications = 0;
+  void on_entity_attribute_change(ha_attr_type, const std::string &) override { this->notifications++; }
+};
+
+struct attribute_update {
+  Entity *entity;
+  ha_attr_type attr;
+  const char *value;
+};
+
+int main() {
+  Entity light("light.front_room"), climate("climate.ecobee"), media("media_player.tv"),
+    sensor("sensor.temp"), cover("cover.blind");
+  NotificationCounter counter;
+  for (auto entity : {&light, &climate, &media, &sensor, &cover}) entity->add_subscriber(&counter);
+
+  const std::vector<attribute_update> sync = {
+    {&light, ha_attr_type::supported_color_modes, "['color_temp', 'hs']"},
+    {&light, ha_attr_type::color_mode, "color_temp"},
+    {&light, ha_attr_type::min_mireds, "153"},
+    {&light, ha_attr_type::max_mireds, "500"},
+    {&light, ha_attr_type::color_temp, "370"},
+    {&light, ha_attr_type::brightness, "180"},
+    {&light, ha_attr_type::effect_list, "['colorloop', 'random', 'Rainbow']"},
+    {&climate, ha_attr_type::temperature, "21.5"},
+    {&climate, ha_attr_type::current_temperature, "20.1"},
+    {&climate, ha_attr_type::hvac_modes, "['off', 'heat', 'cool', 'auto']"},
+    {&climate, ha_attr_type::preset_modes, "['home', 'away', 'sleep']"},
+    {&climate, ha_attr_type::fan_modes, "['auto', 'on']"},
+    {&climate, ha_attr_type::swing_modes, "None"},
+    {&climate, ha_attr_type::target_temp_high, "None"},
+    {&climate, ha_attr_type::target_temp_low, "None"},
+    {&media, ha_attr_type::source_list, "['HDMI 1', 'HDMI 2', 'TV']"},
+    {&media, ha_attr_type::volume_level, "0.35"},
+    {&media, ha_attr_type::media_title, "Some title"},
+    {&media, ha_attr_type::shuffle, "False"},
+    {&sensor, ha_attr_type::device_class, "temperature"},
+    {&sensor, ha_attr_type::unit_of_measurement, "°C"},
+    {&cover, ha_attr_type::current_position, "40"},
+    {&cover, ha_attr_type::supported_features, "15"},
+  };
+
+  const std::vector<std::pair<Entity *, const char *>> states = {
+    {&light, "on"}, {&climate, "heat"}, {&media, "playing"}, {&sensor, "20.1"}, {&cover, "open"}};
+
+  int changed = 0;
+  for (auto &update : sync) changed += update.entity->set_attribute(update.attr, update.value);
+  for (auto &state : states) changed += state.first->set_state(state.second);
+  const int first_sync = counter.notifications;
+  const int first_sync_changed = changed;
+  counter.notifications = 0;
+  changed = 0;
+
+  // HA sends everything again, unchanged, every time it reconnects
+  for (int reconnect = 0; reconnect < 3; reconnect++) {
+    for (auto &update : sync) changed += update.entity->set_attribute(update.attr, update.value);
+    for (auto &state : states) changed += state.first->set_state(state.second);
+  }
+  const int reconnects = counter.notifications;
+  const int reconnects_changed = changed;
+  counter.notifications = 0;
+  changed = 0;
+
+  // different raw values which are stored the same way
+  changed += light.set_attribute(ha_attr_type::brightness, "181");
+  changed += climate.set_attribute(ha_attr_type::preset_modes, "['home','away','sleep']");
+  changed += climate.set_attribute(ha_attr_type::preset_modes,
+    Entity::parse_list_attribute(ha_attr_type::preset_modes, "['home', 'away',  'sleep']"));
+  const int same_normalised = counter.notifications;
+  const int same_normalised_changed = changed;
+
+  std::printf("attribute updates per sync:      %zu\n", sync.size());
+  std::printf("notifications on first sync:     %d (%d changed)\n", first_sync, first_sync_changed);
+  std::printf("notifications, 3 reconnects:     %d (%d changed)\n", reconnects, reconnects_changed);
+  std::printf("same normalised value updates:   %d (%d changed)\n", same_normalised, same_normalised_changed);
+  std::printf("duplicates dropped:              %u\n", Entity::get_duplicate_attribute_updates());
+
+  // the 3 'None' values for attributes which were never stored aren't notified
+  CHECK_EQ(first_sync, static_cast<int>(sync.size()) - 3);
+  CHECK_EQ(first_sync_changed, first_sync + static_cast<int>(states.size()));
+  // a replayed snapshot doesn't re-render anything
+  CHECK_EQ(reconnects, 0);
+  CHECK_EQ(reconnects_changed, 0);
+  CHECK_EQ(same_normalised, 0);
+  CHECK_EQ(same_normalised_changed, 0);
+  // a cleared attribute is a change, clearing it again isn't
+  CHECK(climate.set_attribute(ha_attr_type::fan_modes, "None"));
+  CHECK(!climate.set_attribute(ha_attr_type::fan_modes, "None"));
+
+  // the stored values are unchanged
+  CHECK_EQ(light.get_attribute(ha_attr_type::brightness), "71");
+  CHECK_EQ(climate.get_attribute_list(ha_attr_type::preset_modes).size(), 3u);
+  const std::string color_temp = light.get_attribute(ha_attr_type::color_temp);
+  // a new mireds range means color_temp must be rescaled when it is sent again
+  CHECK(light.set_attribute(ha_attr_type::max_mireds, "454"));
+  CHECK(light.set_attribute(ha_attr_type::color_temp, "370"));
+  std::printf("color_temp: %s, after max_mireds change: %s\n",
+    color_temp.c_str(), light.get_attribute(ha_attr_type::color_temp).c_str());
+  CHECK(light.get_attribute(ha_attr_type::color_temp) != color_temp);
+
+  return host_test_failures;
+}
\ No newline at end of file
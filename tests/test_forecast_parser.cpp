@@ -0,0 +1,362 @@
+// Tests the weather forecast parser against a JSON document parser, with
+// escapes, missing and null fields, truncated input and long forecasts, then
+// compares the time and memory it takes with building the whole document as
+// deserializeJson() did.
+//
+//   test_forecast_parser [--rounds N]
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "forecast_parser.h"
+#include "host_test.h"
+
+using namespace esphome::nspanel_lovelace;
+
+// A JSON document, as the forecast was read before user-023
+struct json_value {
+  enum kind_t { null, boolean, number, string, array, object } kind = null;
+  double num = 0;
+  std::string str;
+  std::vector<json_value> items;
+  std::vector<std::pair<std::string, json_value>> members;
+
+  const json_value *get(const char *key) const {
+    for (auto &member : this->members) {
+      if (member.first == key) return &member.second;
+    }
+    return nullptr;
+  }
+  // the memory held by the document
+  size_t bytes() const {
+    size_t total = this->str.capacity() > 15 ? this->str.capacity() + 1 : 0;
+    total += this->items.capacity() * sizeof(json_value);
+    for (auto &item : this->items) total += item.bytes();
+    total += this->members.capacity() * sizeof(this->members[0]);
+    for (auto &member : this->members) {
+      total += member.first.capacity() > 15 ? member.first.capacity() + 1 : 0;
+      total += member.second.bytes();
+    }
+    return total;
+  }
+};
+
+class DocumentParser {
+public:
+  // only keeps the forecast fields of the items when filtered, as the old filter did
+  bool parse(const std::string &json, json_value &doc, bool filter) {
+    this->json_ = json.c_str();
+    this->filter_ = filter;
+    return this->value_(doc, 0) && (this->ws_(), *this->json_ == '\0');
+  }
+
+protected:
+  void ws_() {
+    while (*this->json_ == ' ' || *this->json_ == '\n' || *this->json_ == '\r' || *this->json_ == '\t')
+      this->json_++;
+  }
+  bool string_(std::string &out) {
+    if (*this->json_++ != '"') return false;
+    while (*this->json_ != '"') {
+      char c = *this->json_++;
+      if (c == '\0') return false;
+      if (c == '\\') {
+        c = *this->json_++;
+        if (c == 'n') c = '\n';
+        else if (c == 't') c = '\t';
+        else if (c == 'r') c = '\r';
+        else if (c == 'b') c = '\b';
+        else if (c == 'f') c = '\f';
+        else if (c == 'u') {
+          // the parser replaces these, the values used are plain ascii
+          for (int i = 0; i < 4; i++) if (!std::isxdigit(*this->json_++)) return false;
+          c = '?';
+        } else if (c != '"' && c != '\\' && c != '/') return false;
+      }
+      out += c;
+    }
+    this->json_++;
+    return true;
+  }
+  bool value_(json_value &out, int depth) {
+    this->ws_();
+    const char c = *this->json_;
+    if (c == '"') {
+      out.kind = json_value::string;
+      return this->string_(out.str);
+    }
+    if (c == '[') {
+      out.kind = json_value::array;
+      this->json_++;
+      this->ws_();
+      if (*this->json_ == ']') return this->json_++, true;
+      do {
+        out.items.emplace_back();
+        if (!this->value_(out.items.back(), depth + 1)) return false;
+        this->ws_();
+      } while (*this->json_ == ',' && this->json_++);
+      return *this->json_++ == ']';
+    }
+    if (c == '{') {
+      out.kind = json_value::object;
+      this->json_++;
+      this->ws_();
+      if (*this->json_ == '}') return this->json_++, true;
+      do {
+        this->ws_();
+        std::string key;
+        if (!this->string_(key)) return false;
+        this->ws_();
+        if (*this->json_++ != ':') return false;
+        json_value value;
+        if (!this->value_(value, depth + 1)) return false;
+        if (!this->filter_ || (depth == 1 &&
+            (key == "datetime" || key == "condition" || key == "temperature")))
+          out.members.emplace_back(std::move(key), std::move(value));
+        this->ws_();
+      } while (*this->json_ == ',' && this->json_++);
+      return *this->json_++ == '}';
+    }
+    const char *start = this->json_;
+    if (std::strncmp(start, "null", 4) == 0) return this->json_ += 4, true;
+    if (std::strncmp(start, "true", 4) == 0) return this->json_ += 4, out.kind = json_value::boolean, true;
+    if (std::strncmp(start, "false", 5) == 0) return this->json_ += 5, out.kind = json_value::boolean, true;
+    char *end = nullptr;
+    out.num = std::strtod(start, &end);
+    if (end == start) return false;
+    out.kind = json_value::number;
+    this->json_ = end;
+    return true;
+  }
+
+  const char *json_ = nullptr;
+  bool filter_ = false;
+};
+
+// What the forecast parser should have read for an item of the document
+static bool same_item(const weather_forecast_item &item, const json_value &expected) {
+  auto text = [](const json_value *value, size_t size) {
+    if (value == nullptr || value->kind != json_value::string) return std::string();
+    return value->str.substr(0, size - 1);
+  };
+  if (text(expected.get("datetime"), sizeof(item.datetime)) != item.datetime) return false;
+  if (text(expected.get("condition"), sizeof(item.condition)) != item.condition) return false;
+  float temperature = NAN;
+  if (auto value = expected.get("temperature")) {
+    if (value->kind == json_value::number) {
+      temperature = value->num;
+    } else if (value->kind == json_value::string) {
+      char *end = nullptr;
+      const float number = std::strtof(value->str.c_str(), &end);
+      if (end != value->str.c_str() && *end == '\0') temperature = number;
+    }
+  }
+  return std::isnan(temperature) ? std::isnan(item.temperature) : temperature == item.temperature;
+}
+
+// Parses the json with both parsers and compares the items read
+static bool same_as_document(const std::string &json, size_t max_items = ForecastParser::MAX_ITEMS) {
+  json_value doc;
+  if (!DocumentParser().parse(json, doc, false)) {
+    std::fprintf(stderr, "invalid test json: %s\n", json.c_str());
+    return false;
+  }
+  ForecastParser forecast;
+  if (!forecast.parse(json, max_items)) {
+    std::fprintf(stderr, "%s at %zu: %s\n", forecast.get_error(), forecast.get_error_position(), json.c_str());
+    return false;
+  }
+  const size_t expected = std::min({doc.items.size(), max_items, ForecastParser::MAX_ITEMS});
+  if (forecast.size() != expected) return false;
+  for (size_t i = 0; i < expected; i++) {
+    if (!same_item(forecast[i], doc.items[i])) {
+      std::fprintf(stderr, "item %zu differs: %s\n", i, json.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::string forecast_item(std::mt19937 &rng, int hour) {
+  static const char *conditions[] = {"sunny", "partlycloudy", "clear-night", "rainy", "lightning-rainy"};
+  char datetime[32];
+  std::snprintf(datetime, sizeof(datetime), "2023-08-22T%02d:00:00+00:00", hour % 24);
+  char temperature[16];
+  std::snprintf(temperature, sizeof(temperature), "%.1f", std::uniform_int_distribution<int>(-150, 350)(rng) / 10.0);
+  std::vector<std::string> fields = {
+    std::string("\"condition\": \"") + conditions[rng() % 5] + "\"",
+    std::string("\"datetime\": \"") + datetime + "\"",
+    std::string("\"temperature\": ") + temperature,
+    "\"wind_bearing\": 166.2", "\"wind_speed\": 12.96", "\"precipitation\": 0.0",
+    "\"precipitation_probability\": 10", "\"humidity\": 74", "\"templow\": null",
+    "\"is_daytime\": false", "\"cloud_coverage\": 40.5"};
+  // HA keeps the order, other integrations don't
+  std::shuffle(fields.begin(), fields.end(), rng);
+  std::string item = "{";
+  for (auto &field : fields) item += (item.size() > 1 ? ", " : "") + field;
+  return item + "}";
+}
+
+static std::string forecast_json(std::mt19937 &rng, size_t items) {
+  std::string json = "[";
+  for (size_t i = 0; i < items; i++) json += (i > 0 ? ", " : "") + forecast_item(rng, i);
+  return json + "]";
+}
+
+static void test_escapes() {
+  CHECK(same_as_document(R"([{"condition": "clear-\"night\"", "datetime": "2023\/08\/22"}])"));
+  CHECK(same_as_document(R"([{"condition": "a\\b\n\t\r\b\f", "temperature": 1}])"));
+  CHECK(same_as_document(R"([{"condition": "caf\u00e9 \u2603", "temperature": 2}])"));
+  CHECK(same_as_document("[{\"condition\": \"caf\xc3\xa9\", \"temperature\": 2}]"));
+  // escaped quotes and brackets in values which are skipped
+  CHECK(same_as_document(R"([{"note": "}]\"{[", "nested": {"a": ["}", "\"]"]}, "condition": "fog"}])"));
+  CHECK(same_as_document(R"([{"con\"dition": "x", "condition": "hail"}])"));
+  // values longer than the buffers are truncated
+  CHECK(same_as_document("[{\"condition\": \"" + std::string(100, 'c') + "\", \"datetime\": \"" +
+    std::string(31, 'd') + "\\\"" + std::string(10, 'd') + "\"}]"));
+
+  ForecastParser forecast;
+  CHECK(forecast.parse(R"([{"condition": "a\"b\\c\u0041"}])"));
+  CHECK_EQ(std::string(forecast[0].condition), "a\"b\\c?");
+}
+
+static void test_missing_fields() {
+  CHECK(same_as_document("[]"));
+  CHECK(same_as_document(" [ { } , {}\n]\n"));
+  CHECK(same_as_document(R"([{"datetime": null, "condition": null, "temperature": null}])"));
+  CHECK(same_as_document(R"([{"condition": "rainy"}, {"temperature": 3}, {"datetime": "2023-08-22T21:00:00+00:00"}])"));
+  CHECK(same_as_document(R"([{"temperature": "21.5"}, {"temperature": "warm"}, {"temperature": true}])"));
+  CHECK(same_as_document(R"([{"temperature": 1e2}, {"temperature": -0.5}, {"temperature": -1.25E-1}])"));
+  CHECK(same_as_document(R"([{"condition": 5, "datetime": ["2023"], "temperature": {"value": 3}}])"));
+
+  ForecastParser forecast;
+  CHECK(forecast.parse(R"([{"condition": "sunny", "temperature": null}])"));
+  CHECK_EQ(forecast.size(), 1u);
+  CHECK_EQ(forecast[0].datetime[0], '\0');
+  CHECK(std::isnan(forecast[0].temperature));
+  // numbers which don't fit the buffer aren't read
+  CHECK(forecast.parse(R"([{"temperature": 12345678901234567890}])"));
+  CHECK(std::isnan(forecast[0].temperature));
+  CHECK(!forecast.parse("{}"));
+  CHECK_EQ(std::string(forecast.get_error()), "expected an array");
+  CHECK(!forecast.parse(""));
+  CHECK(!forecast.parse(R"([{"condition" "sunny"}])"));
+  CHECK_EQ(std::string(forecast.get_error()), "expected ':'");
+  CHECK(!forecast.parse(R"([{"condition": "sunny"} {"condition": "rainy"}])"));
+  CHECK_EQ(std::string(forecast.get_error()), "expected ',' or ']'");
+  CHECK_EQ(forecast.size(), 1u);
+}
+
+static void test_truncated() {
+  std::mt19937 rng(1);
+  const std::string json = forecast_json(rng, 6);
+  json_value doc;
+  CHECK(DocumentParser().parse(json, doc, false));
+
+  // every prefix, the parser must stop at the end of it without reading further
+  size_t first_complete = json.size();
+  size_t failures = 0;
+  for (size_t len = 0; len <= json.size(); len++) {
+    // a copy so reading past the end is caught by the sanitizers
+    const std::string prefix = json.substr(0, len);
+    ForecastParser forecast;
+    const bool ok = forecast.parse(prefix);
+    if (ok) {
+      first_complete = std::min(first_complete, len);
+      if (forecast.size() != ForecastParser::MAX_ITEMS) failures++;
+    } else {
+      if (len >= first_complete) failures++;
+      if (forecast.get_error() == nullptr || forecast.get_error_position() > len) failures++;
+    }
+    // the items read before the end are still available
+    for (size_t i = 0; i < forecast.size(); i++) failures += !same_item(forecast[i], doc.items[i]);
+  }
+  std::printf("truncated forecasts: %zu prefixes, complete after %zu bytes, %zu failures\n",
+    json.size() + 1, first_complete, failures);
+  CHECK_EQ(failures, 0u);
+  // complete as soon as the ',' after the last item needed is read
+  size_t item_end = 0;
+  for (size_t i = 0; i < ForecastParser::MAX_ITEMS; i++) item_end = json.find("}, {", item_end) + 1;
+  CHECK_EQ(first_complete, item_end + 1);
+}
+
+static void test_long_forecast() {
+  std::mt19937 rng(2);
+  const std::string json = forecast_json(rng, 24);
+  CHECK(same_as_document(json));
+  CHECK(same_as_document(json, 2));
+  CHECK(same_as_document(json, 100));
+  ForecastParser forecast;
+  CHECK(forecast.parse(json, 100));
+  CHECK_EQ(forecast.size(), ForecastParser::MAX_ITEMS);
+
+  // anything after the items needed isn't looked at
+  std::string cut = "[";
+  for (size_t i = 0; i < ForecastParser::MAX_ITEMS; i++) cut += forecast_item(rng, i) + ", ";
+  CHECK(forecast.parse(cut + "not json"));
+  CHECK_EQ(forecast.size(), ForecastParser::MAX_ITEMS);
+
+  // random forecasts of any length
+  size_t mismatches = 0;
+  for (int round = 0; round < 200; round++) {
+    mismatches += !same_as_document(forecast_json(rng, rng() % 8), rng() % 6);
+  }
+  std::printf("mismatches with the document parser: %zu\n", mismatches);
+  CHECK_EQ(mismatches, 0u);
+}
+
+static void benchmark(size_t rounds) {
+  std::mt19937 rng(3);
+  const std::string json = forecast_json(rng, 24);
+  using clock = std::chrono::steady_clock;
+  auto time = [&](auto &&parse) {
+    auto start = clock::now();
+    for (size_t i = 0; i < rounds; i++) CHECK(parse());
+    return std::chrono::duration<double, std::micro>(clock::now() - start).count() / rounds;
+  };
+
+  size_t document_bytes = 0, filtered_bytes = 0;
+  const double document_us = time([&] {
+    json_value doc;
+    const bool ok = DocumentParser().parse(json, doc, false);
+    document_bytes = doc.bytes();
+    return ok;
+  });
+  const double filtered_us = time([&] {
+    json_value doc;
+    const bool ok = DocumentParser().parse(json, doc, true);
+    filtered_bytes = doc.bytes();
+    return ok;
+  });
+  const double forecast_us = time([&] {
+    ForecastParser forecast;
+    return forecast.parse(json, ForecastParser::MAX_ITEMS);
+  });
+
+  std::printf("%zu rounds of a %zu byte forecast of 24 items:\n", rounds, json.size());
+  std::printf("  %-20s %8s %12s\n", "", "us", "heap bytes");
+  std::printf("  %-20s %8.2f %12zu\n", "document", document_us, document_bytes);
+  std::printf("  %-20s %8.2f %12zu\n", "filtered document", filtered_us, filtered_bytes);
+  std::printf("  %-20s %8.2f %12d (%zu on the stack)\n", "forecast parser", forecast_us, 0, sizeof(ForecastParser));
+}
+
+int main(int argc, char **argv) {
+  size_t rounds = 2000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--rounds") == 0) rounds = std::strtoul(argv[i + 1], nullptr, 10);
+  }
+
+  test_escapes();
+  test_missing_fields();
+  test_truncated();
+  test_long_forecast();
+  benchmark(rounds);
+
+  return host_test_failures;
+}
\ No newline at end of file
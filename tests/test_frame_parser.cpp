@@ -0,0 +1,321 @@
+// Tests the ring buffer and the frame parser, including resynchronising after
+// noise, then compares the cost of parsing frames with the byte at a time
+// parser it replaced.
+//
+//   test_frame_parser [--frames N]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "esphome/core/helpers.h"
+
+#include "crc16.h"
+#include "frame_parser.h"
+#include "host_test.h"
+#include "ring_buffer.h"
+
+using namespace esphome;
+using namespace esphome::nspanel_lovelace;
+
+static std::vector<uint8_t> make_frame(const std::string &payload) {
+  std::vector<uint8_t> frame(4 + payload.size());
+  frame[0] = FRAME_HEADER1;
+  frame[1] = FRAME_HEADER2;
+  frame[2] = payload.size() & 0xFF;
+  frame[3] = payload.size() >> 8;
+  std::copy(payload.begin(), payload.end(), frame.begin() + 4);
+  const uint16_t crc = Crc16::calculate(frame.data(), frame.size());
+  frame.push_back(crc & 0xFF);
+  frame.push_back(crc >> 8);
+  return frame;
+}
+
+// Feeds the data to the parser in pieces of 'piece' bytes and collects the results
+struct parsed {
+  std::vector<frame_result> results;
+  std::vector<std::string> payloads;
+  size_t discarded = 0;
+};
+static parsed feed(FrameParser &parser, const std::vector<uint8_t> &data, size_t piece) {
+  parsed out;
+  auto &buffer = parser.get_buffer();
+  for (size_t i = 0; i < data.size();) {
+    size_t len;
+    uint8_t *region = buffer.write_region(len);
+    len = std::min({len, piece, data.size() - i});
+    std::memcpy(region, &data[i], len);
+    buffer.commit(len);
+    i += len;
+    frame_result result;
+    while ((result = parser.parse()) != frame_result::incomplete) {
+      out.results.push_back(result);
+      if (result == frame_result::frame) {
+        out.payloads.emplace_back(reinterpret_cast<const char *>(parser.get_payload()),
+          parser.get_payload_length());
+      }
+      if (result == frame_result::invalid) out.discarded += parser.get_discarded_length();
+    }
+  }
+  return out;
+}
+
+static void test_ring_buffer() {
+  RingBuffer<8> buffer;
+  size_t len;
+  uint8_t *region = buffer.write_region(len);
+  CHECK_EQ(len, 8u);
+  std::memcpy(region, "abcdef", 6);
+  buffer.commit(6);
+  CHECK_EQ(buffer.size(), 6u);
+  CHECK_EQ(buffer.peek(2), 'c');
+  buffer.pop(4);
+  CHECK_EQ(buffer.free(), 6u);
+
+  // the free space wraps around, so it is handed out in two regions
+  region = buffer.write_region(len);
+  CHECK_EQ(len, 2u);
+  std::memcpy(region, "gh", 2);
+  buffer.commit(2);
+  region = buffer.write_region(len);
+  CHECK_EQ(len, 4u);
+  std::memcpy(region, "ijkl", 4);
+  buffer.commit(len);
+  CHECK(buffer.full());
+  buffer.write_region(len);
+  CHECK_EQ(len, 0u);
+
+  char copy[9] = {};
+  buffer.copy_to(reinterpret_cast<uint8_t *>(copy), 0, 8);
+  CHECK_EQ(std::string(copy), "efghijkl");
+  CHECK_EQ(buffer.peek(7), 'l');
+  // commit and pop are limited to what fits or is available
+  buffer.commit(3);
+  CHECK_EQ(buffer.size(), 8u);
+  buffer.pop(20);
+  CHECK(buffer.empty());
+}
+
+static void test_frames() {
+  const std::vector<std::string> payloads = {
+    "event,startup,53,eu", "", "event,buttonPress2,light.kitchen,OnOff,1",
+    std::string(FRAME_MAX_PAYLOAD_SIZE, 'x')};
+  std::vector<uint8_t> data = {0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
+  for (auto &payload : payloads) {
+    auto frame = make_frame(payload);
+    data.insert(data.end(), frame.begin(), frame.end());
+  }
+  data.insert(data.end(), {0x88, 0xFF, 0xFF, 0xFF});
+
+  // the result doesn't depend on how the data is split up by the UART
+  for (size_t piece : {size_t{1}, size_t{3}, size_t{64}, UART_RX_BUFFER_SIZE}) {
+    FrameParser parser;
+    auto out = feed(parser, data, piece);
+    CHECK_EQ(out.results.size(), payloads.size() + 2);
+    CHECK(out.results.front() == frame_result::nextion_startup);
+    CHECK(out.results.back() == frame_result::nextion_ready);
+    CHECK(out.payloads == payloads);
+    CHECK(parser.get_buffer().empty());
+    CHECK_EQ(parser.get_resync_count(), 0u);
+  }
+}
+
+static std::vector<uint8_t> join(std::initializer_list<std::vector<uint8_t>> parts) {
+  std::vector<uint8_t> data;
+  for (auto &part : parts) data.insert(data.end(), part.begin(), part.end());
+  return data;
+}
+
+// A frame starting inside data which fails to parse is still received
+static void test_resync() {
+  const auto frame = make_frame("event,buttonPress2,light.kitchen,OnOff,1");
+  const std::vector<uint8_t> startup = {0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
+  // the header of a frame which was cut short
+  const std::vector<uint8_t> truncated = {FRAME_HEADER1, FRAME_HEADER2, 30, 0, 'e', 'v', 'e'};
+  auto corrupt = frame;
+  corrupt[10] ^= 0x20;
+
+  struct resync_case {
+    const char *name;
+    std::vector<uint8_t> data;
+    std::vector<frame_result> results;
+    size_t discarded;
+    uint32_t recovered;
+  };
+  const std::vector<resync_case> cases = {
+    {"noise before a frame", join({{'a', 'b', 0xBB}, frame}),
+      {frame_result::invalid, frame_result::frame}, 3, 0},
+    {"header without 0xBB", join({{FRAME_HEADER1, 'x'}, frame}),
+      {frame_result::invalid, frame_result::frame}, 2, 0},
+    {"length too large", join({{FRAME_HEADER1, FRAME_HEADER2, 0xFF, 0xFF}, frame}),
+      {frame_result::invalid, frame_result::frame}, 4, 0},
+    {"invalid checksum", join({corrupt, frame}),
+      {frame_result::invalid, frame_result::frame}, corrupt.size(), 0},
+    {"frame inside a truncated frame", join({truncated, frame}),
+      {frame_result::invalid, frame_result::frame}, truncated.size(), 1},
+    {"startup inside a truncated frame", join({truncated, startup, frame, frame}),
+      {frame_result::invalid, frame_result::nextion_startup, frame_result::frame, frame_result::frame},
+      truncated.size(), 1},
+  };
+
+  for (auto &test : cases) {
+    for (size_t piece : {size_t{1}, size_t{5}, UART_RX_BUFFER_SIZE}) {
+      FrameParser parser;
+      auto out = feed(parser, test.data, piece);
+      // data arriving in small pieces can be discarded in more than one go
+      out.results.erase(std::unique(out.results.begin(), out.results.end(),
+        [](frame_result a, frame_result b) { return a == frame_result::invalid && a == b; }), out.results.end());
+      if (out.results != test.results || out.discarded != test.discarded ||
+          parser.get_resync_count() == 0 || parser.get_recovered_count() != test.recovered) {
+        std::fprintf(stderr, "%s (%zu byte pieces): results=%zu discarded=%zu resyncs=%u recovered=%u\n",
+          test.name, piece, out.results.size(), out.discarded,
+          parser.get_resync_count(), parser.get_recovered_count());
+        host_test_failures++;
+      }
+      for (auto &payload : out.payloads) CHECK_EQ(payload, "event,buttonPress2,light.kitchen,OnOff,1");
+    }
+  }
+}
+
+// The parser which read one byte at a time into a vector (before user-001)
+class BytewiseParser {
+public:
+  size_t frames = 0;
+
+  void push(uint8_t byte) {
+    this->buffer_.push_back(byte);
+    if (!this->process_()) this->buffer_.clear();
+  }
+
+protected:
+  static uint16_t crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    while (len--) {
+      crc ^= *data++;
+      for (uint8_t i = 0; i < 8; i++) crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    }
+    return crc;
+  }
+
+  bool process_() {
+    const size_t at = this->buffer_.size() - 1;
+    const uint8_t *data = this->buffer_.data();
+    if (at == 0) return data[0] == FRAME_HEADER1;
+    if (at == 1) return data[1] == FRAME_HEADER2;
+    if (at < 4) return true;
+    const uint16_t length = encode_uint16(data[3], data[2]);
+    if (at - 4 < length || at == 4u + length) return true;
+    if (encode_uint16(data[at], data[at - 1]) != crc16(data, 4 + length)) return false;
+    this->message_.assign(data + 4, data + 4 + length);
+    this->frames++;
+    this->buffer_.clear();
+    return true;
+  }
+
+  std::vector<uint8_t> buffer_;
+  std::string message_;
+};
+
+// Corrupts bytes in a stream of frames, every frame which wasn't touched must
+// still be received. The byte at a time parser dropped everything buffered.
+static void test_noise(unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> percent(0, 99), byte(0, 255);
+  std::vector<uint8_t> data;
+  std::vector<std::string> intact;
+  size_t corrupted = 0;
+  for (int i = 0; i < 2000; i++) {
+    const std::string payload = "event,buttonPress2,cover.blind,up," + std::to_string(i);
+    auto frame = make_frame(payload);
+    if (percent(rng) < 10) {
+      frame[std::uniform_int_distribution<size_t>(0, frame.size() - 1)(rng)] = byte(rng);
+      corrupted++;
+    } else if (percent(rng) < 5) {
+      // the rest of the frame was lost
+      frame.resize(std::uniform_int_distribution<size_t>(1, frame.size() - 1)(rng));
+      corrupted++;
+    } else {
+      intact.push_back(payload);
+    }
+    data.insert(data.end(), frame.begin(), frame.end());
+  }
+
+  FrameParser parser;
+  auto out = feed(parser, data, 37);
+  BytewiseParser bytewise;
+  for (auto b : data) bytewise.push(b);
+  std::printf("noise (seed %u): %zu of 2000 frames damaged, received %zu, byte at a time %zu, "
+    "resyncs=%u recovered=%u\n", seed, corrupted, out.payloads.size(), bytewise.frames,
+    parser.get_resync_count(), parser.get_recovered_count());
+  // a corrupted byte can only make the frame it is in invalid
+  size_t found = 0;
+  for (auto &payload : out.payloads) {
+    if (found < intact.size() && payload == intact[found]) found++;
+  }
+  CHECK_EQ(found, intact.size());
+  CHECK(parser.get_recovered_count() > 0);
+}
+
+static void benchmark(size_t frame_count) {
+  // a slider drag sends a frame every few ms, each is read as soon as it arrives
+  std::vector<uint8_t> data;
+  for (size_t i = 0; i < 64; i++) {
+    auto frame = make_frame("event,buttonPress2,light.living_room_lamp,brightnessSlider," + std::to_string(i));
+    data.insert(data.end(), frame.begin(), frame.end());
+  }
+  const size_t rounds = std::max<size_t>(1, frame_count / 64);
+  using clock = std::chrono::steady_clock;
+  auto report = [&](const char *name, clock::duration elapsed, size_t frames) {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    std::printf("  %-10s %8zu frames %8.1f MB/s %8.1f ns/frame\n", name, frames,
+      rounds * data.size() / seconds / 1e6, seconds * 1e9 / frames);
+    return frames;
+  };
+
+  std::printf("parsing %zu frames of %zu bytes:\n", rounds * 64, data.size() / 64);
+  BytewiseParser bytewise;
+  auto start = clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    for (auto byte : data) bytewise.push(byte);
+  }
+  CHECK_EQ(report("bytewise", clock::now() - start, bytewise.frames), rounds * 64);
+
+  // the same as NSPanelLovelace::loop(), with reads of up to 128 bytes
+  FrameParser parser;
+  auto &buffer = parser.get_buffer();
+  size_t frames = 0;
+  start = clock::now();
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < data.size();) {
+      size_t len;
+      uint8_t *region = buffer.write_region(len);
+      len = std::min({len, size_t{128}, data.size() - i});
+      std::memcpy(region, &data[i], len);
+      buffer.commit(len);
+      i += len;
+      frame_result result;
+      while ((result = parser.parse()) != frame_result::incomplete) {
+        if (result == frame_result::frame) frames++;
+      }
+    }
+  }
+  CHECK_EQ(report("bulk", clock::now() - start, frames), rounds * 64);
+}
+
+int main(int argc, char **argv) {
+  size_t frames = 64 * 1000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--frames") == 0) frames = std::strtoul(argv[i + 1], nullptr, 10);
+  }
+
+  test_ring_buffer();
+  test_frames();
+  test_resync();
+  for (unsigned seed = 1; seed <= 3; seed++) test_noise(seed);
+  benchmark(frames);
+
+  return host_test_failures;
+}
\ No newline at end of file
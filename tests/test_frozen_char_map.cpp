@@ -0,0 +1,138 @@
+// Checks the binary search of every sorted FrozenCharMap against a linear
+// strcmp scan, as the lookups were done before, with and without a fallback
+// key, then compares how long they take.
+//
+//   test_frozen_char_map [--lookups N]
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "host_test.h"
+#include "types.h"
+
+using namespace esphome::nspanel_lovelace;
+
+// the lookup in try_get_value() before user-015
+template<typename Value, size_t Size>
+static const std::pair<const char *, Value> *linear_find(const FrozenCharMap<Value, Size> &map, const char *key) {
+  for (auto &entry : map) {
+    if (std::strcmp(entry.first, key) == 0) return &entry;
+  }
+  return nullptr;
+}
+
+static bool same_value(const char *a, const char *b) { return a == b; }
+static bool same_value(const Icon &a, const Icon &b) { return a.value == b.value && a.color == b.color; }
+static bool same_value(const std::array<const char *, 4> &a, const std::array<const char *, 4> &b) { return a == b; }
+
+// every key, and keys which are close to them but must not be found
+template<typename Value, size_t Size>
+static std::vector<std::string> lookup_keys(const FrozenCharMap<Value, Size> &map) {
+  std::vector<std::string> keys = {"", "~", "\x01", "unknown_key"};
+  for (auto &entry : map) {
+    const std::string key = entry.first;
+    keys.push_back(key);
+    keys.push_back(key + "_");
+    keys.push_back(key.substr(0, key.size() - 1));
+    keys.push_back(" " + key);
+    std::string upper = key;
+    upper[0] = std::toupper(upper[0]);
+    keys.push_back(upper);
+  }
+  return keys;
+}
+
+template<typename Value, size_t Size>
+static size_t check_map(const char *name, const FrozenCharMap<Value, Size> &map) {
+  const auto keys = lookup_keys(map);
+  const Value default_value{};
+  size_t mismatches = 0;
+  for (auto &key : keys) {
+    auto expected = linear_find(map, key.c_str());
+    if (find_entry(map, key.c_str()) != expected) mismatches++;
+    if (find_entry(map, std::string_view(key)) != expected) mismatches++;
+
+    Value value = default_value;
+    const bool found = try_get_value(map, value, key);
+    if (found != (expected != nullptr && !key.empty())) mismatches++;
+    if (found && !same_value(value, expected->second)) mismatches++;
+    auto &or_default = get_value_or_default(map, key, default_value);
+    if (&or_default != (expected != nullptr && !key.empty() ? &expected->second : &default_value)) mismatches++;
+
+    // the fallback key is only used when the key isn't found
+    for (const char *fallback : {map[0].first, map[Size - 1].first, "unknown_key", ""}) {
+      auto fallback_entry = linear_find(map, fallback);
+      auto want = expected != nullptr && !key.empty() ? expected :
+                  fallback[0] != '\0' ? fallback_entry : nullptr;
+      value = default_value;
+      if (try_get_value(map, value, key, fallback) != (want != nullptr)) mismatches++;
+      if (want != nullptr && !same_value(value, want->second)) mismatches++;
+      auto &with_fallback = get_value_or_default(map, key, default_value, fallback);
+      if (&with_fallback != (want != nullptr ? &want->second : &default_value)) mismatches++;
+    }
+  }
+  if (mismatches != 0) std::fprintf(stderr, "%s: %zu mismatches\n", name, mismatches);
+  return mismatches;
+}
+
+template<typename Value, size_t Size>
+static void benchmark(const char *name, const FrozenCharMap<Value, Size> &map, size_t lookups) {
+  // only the keys which are in the map, the misses make the scan look worse
+  std::vector<std::string> keys;
+  for (auto &entry : map) keys.push_back(entry.first);
+
+  using clock = std::chrono::steady_clock;
+  auto time = [&](auto &&find) {
+    size_t found = 0;
+    auto start = clock::now();
+    for (size_t i = 0; i < lookups; i++) found += find(keys[i % Size].c_str()) != nullptr;
+    CHECK_EQ(found, lookups);
+    return std::chrono::duration<double, std::nano>(clock::now() - start).count() / lookups;
+  };
+  const double linear_ns = time([&](const char *key) { return linear_find(map, key); });
+  const double binary_ns = time([&](const char *key) { return find_entry(map, key); });
+  std::printf("  %-24s %4zu %8.1f %8.1f\n", name, Size, linear_ns, binary_ns);
+}
+
+#define FOR_EACH_MAP(F) \
+  F(ENTITY_ICON_MAP) \
+  F(SENSOR_ON_ICON_MAP) \
+  F(SENSOR_OFF_ICON_MAP) \
+  F(SENSOR_ICON_MAP) \
+  F(WEATHER_ICON_MAP) \
+  F(CLIMATE_ICON_MAP) \
+  F(MEDIA_TYPE_ICON_MAP) \
+  F(ALARM_ICON_MAP) \
+  F(COVER_MAP) \
+  F(ENTITY_RENDER_TYPE_MAP)
+
+int main(int argc, char **argv) {
+  size_t lookups = 1000000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--lookups") == 0) lookups = std::strtoul(argv[i + 1], nullptr, 10);
+  }
+
+  size_t mismatches = 0;
+#define CHECK_MAP(map) mismatches += check_map(#map, map);
+  FOR_EACH_MAP(CHECK_MAP)
+#undef CHECK_MAP
+  std::printf("mismatches with the linear scan: %zu\n", mismatches);
+  CHECK_EQ(mismatches, 0u);
+
+  // the icon helpers used by the entities
+  CHECK(get_icon(ENTITY_ICON_MAP, entity_type::scene) == icon_t::palette);
+  CHECK(get_icon(ENTITY_ICON_MAP, "no_such_domain") == icon_t::alert_circle_outline);
+  CHECK(get_icon(ENTITY_ICON_MAP, "no_such_domain", entity_type::scene) == icon_t::palette);
+  CHECK(get_icon(ENTITY_ICON_MAP, "", entity_type::scene) == icon_t::palette);
+
+  std::printf("%zu lookups of the keys in each map (ns/lookup):\n", lookups);
+  std::printf("  %-24s %4s %8s %8s\n", "map", "keys", "linear", "binary");
+#define BENCHMARK_MAP(map) benchmark(#map, map, lookups);
+  FOR_EACH_MAP(BENCHMARK_MAP)
+#undef BENCHMARK_MAP
+
+  return host_test_failures;
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+// Tests the entity and page item indexes, then compares the lookup cost with
+// the linear scan (and single entry cache) they replaced.
+//
+//   test_lookup_index [--lookups N]
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "entity.h"
+#include "host_test.h"
+#include "lookup_index.h"
+
+using namespace esphome::nspanel_lovelace;
+
+struct entity_id_key {
+  const std::string &operator()(const Entity *entity) const { return entity->get_entity_id(); }
+};
+
+struct item {
+  std::string uuid;
+};
+struct uuid_key {
+  const std::string &operator()(const item *item) const { return item->uuid; }
+};
+using item_index = UuidIndex<item, uuid_key>;
+
+static void test_hash_index() {
+  // "costarring" and "liquid" have the same FNV-1a hash
+  static_assert(fnv1a_hash("costarring") == fnv1a_hash("liquid"), "not a collision");
+  Entity a("sensor.a"), b("costarring"), c("liquid"), d("light.kitchen");
+  HashIndex<Entity, entity_id_key> index;
+  for (auto entity : {&d, &c, &a, &b}) index.insert(entity);
+  CHECK_EQ(index.size(), 4u);
+  CHECK(index.find("sensor.a") == &a);
+  CHECK(index.find("costarring") == &b);
+  CHECK(index.find("liquid") == &c);
+  CHECK(index.find("light.kitchen") == &d);
+  CHECK(index.find("light.kitche") == nullptr);
+  CHECK(index.find("") == nullptr);
+  index.clear();
+  CHECK(index.find("sensor.a") == nullptr);
+}
+
+static void test_uuid_index() {
+  CHECK_EQ(item_index::parse_index("0"), 0);
+  CHECK_EQ(item_index::parse_index("1024"), 1024);
+  CHECK_EQ(item_index::parse_index("1025"), -1);
+  CHECK_EQ(item_index::parse_index("012"), -1);
+  CHECK_EQ(item_index::parse_index("12a"), -1);
+  CHECK_EQ(item_index::parse_index(""), -1);
+
+  // numbers are stored in the table, anything else in the hash index
+  item zero{"0"}, small{"42"}, padded{"042"}, large{"5000"}, text{"uuid.abc"};
+  item_index index;
+  for (auto i : {&zero, &small, &padded, &large, &text}) index.insert(i);
+  CHECK_EQ(index.size(), 5u);
+  CHECK(index.find("0") == &zero);
+  CHECK(index.find("42") == &small);
+  CHECK(index.find("042") == &padded);
+  CHECK(index.find("5000") == &large);
+  CHECK(index.find("uuid.abc") == &text);
+  CHECK(index.find("41") == nullptr);
+  CHECK(index.find("43") == nullptr);
+  CHECK(index.find("1000") == nullptr);
+}
+
+// NSPanelLovelace::get_entity_() before the index was added
+static Entity *scan(std::vector<std::unique_ptr<Entity>> &entities, Entity *&cached, const std::string &entity_id) {
+  if (cached != nullptr && cached->get_entity_id() == entity_id) return cached;
+  for (auto &entity : entities) {
+    if (entity->get_entity_id() != entity_id) continue;
+    return cached = entity.get();
+  }
+  return cached = nullptr;
+}
+
+static void benchmark(size_t lookups) {
+  static const char *domains[] = {"light", "sensor", "switch", "binary_sensor", "climate", "cover"};
+  using clock = std::chrono::steady_clock;
+  std::printf("%zu lookups of random entities (ns/lookup):\n", lookups);
+  std::printf("  entities      scan     index   uuid table\n");
+  for (size_t count : {10, 100, 1000}) {
+    std::vector<std::unique_ptr<Entity>> entities;
+    std::vector<std::unique_ptr<item>> items;
+    HashIndex<Entity, entity_id_key> entity_index;
+    item_index uuids_index;
+    for (size_t i = 0; i < count; i++) {
+      entities.push_back(std::make_unique<Entity>(
+        std::string(domains[i % 6]) + ".living_room_device_" + std::to_string(i)));
+      entity_index.insert(entities.back().get());
+      items.push_back(std::make_unique<item>(item{std::to_string(i)}));
+      uuids_index.insert(items.back().get());
+    }
+    // HA updates arrive for entities in no particular order
+    std::mt19937 rng(count);
+    std::vector<std::string> ids, uuids;
+    for (size_t i = 0; i < 1024; i++) {
+      const size_t n = std::uniform_int_distribution<size_t>(0, count - 1)(rng);
+      ids.push_back(entities[n]->get_entity_id());
+      uuids.push_back(items[n]->uuid);
+    }
+
+    auto time = [&](auto &&lookup) {
+      size_t found = 0;
+      auto start = clock::now();
+      for (size_t i = 0; i < lookups; i++) found += lookup(i % 1024) != nullptr;
+      CHECK_EQ(found, lookups);
+      return std::chrono::duration<double, std::nano>(clock::now() - start).count() / lookups;
+    };
+    Entity *cached = nullptr;
+    const double scan_ns = time([&](size_t i) { return scan(entities, cached, ids[i]); });
+    const double index_ns = time([&](size_t i) { return entity_index.find(ids[i]); });
+    const double uuid_ns = time([&](size_t i) { return uuids_index.find(uuids[i]); });
+    std::printf("  %8zu %9.1f %9.1f %12.1f\n", count, scan_ns, index_ns, uuid_ns);
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t lookups = 200000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--lookups") == 0) lookups = std::strtoul(argv[i + 1], nullptr, 10);
+  }
+
+  test_hash_index();
+  test_uuid_index();
+  benchmark(lookups);
+
+  return host_test_failures;
+}
\ No newline at end of file
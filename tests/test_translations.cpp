@@ -0,0 +1,54 @@
+// Looks up every key of a translation file in the table generated from it by
+// build_translation_table() in __init__.py, once with the keys from the file
+// (after TRANSLATION_KEY_ALIASES) and once with the translation_item keys the
+// C++ code uses. Built once for each file in the translations directory.
+#include <cstring>
+#include <string>
+
+#include "host_test.h"
+#include TRANSLATIONS_HEADER
+
+using namespace esphome::nspanel_lovelace;
+
+static bool translates_to(const char *key, const char *value) {
+  const char *found = nullptr;
+  if (!try_get_translation(key, found) || std::strcmp(found, value) != 0) return false;
+  // list attribute items are looked up without a null terminator
+  const std::string padded = std::string(key) + "~";
+  found = nullptr;
+  if (!try_get_translation(std::string_view(padded.data(), padded.size() - 1), found) ||
+      std::strcmp(found, value) != 0)
+    return false;
+  return std::strcmp(get_translation(key), value) == 0;
+}
+
+int main() {
+  static_assert(is_valid_translation_table(TRANSLATION_MAP, TRANSLATION_SEEDS),
+    "TRANSLATION_MAP does not match the translation keys");
+
+  size_t keys = 0;
+  for (auto &entry : TRANSLATION_FILE_ENTRIES) {
+    if (!translates_to(entry.first, entry.second)) {
+      std::fprintf(stderr, "%s: not translated to '%s'\n", entry.first, entry.second);
+      host_test_failures++;
+    }
+    keys++;
+  }
+  for (auto &entry : TRANSLATION_ITEM_ENTRIES) {
+    if (!translates_to(entry.first, entry.second)) {
+      std::fprintf(stderr, "translation_item %s: not translated to '%s'\n", entry.first, entry.second);
+      host_test_failures++;
+    }
+  }
+  std::printf("%zu keys, %zu translation items\n", keys,
+    sizeof(TRANSLATION_ITEM_ENTRIES) / sizeof(*TRANSLATION_ITEM_ENTRIES));
+
+  // keys which aren't in the table are returned unchanged
+  const char *value = nullptr;
+  CHECK(!try_get_translation("", value));
+  CHECK(!try_get_translation("tilt_position_", value));
+  CHECK(!try_get_translation(std::string_view("month_jan", 8), value));
+  CHECK(std::strcmp(get_translation("no_such_key"), "no_such_key") == 0);
+
+  return host_test_failures;
+}
\ No newline at end of file
@@ -0,0 +1,297 @@
+// Tests the UART receive task and simulates the button press to dispatch
+// latency with frames read in loop() (mode off) or by the task (mode on).
+//
+//   test_uart_receiver [--seconds N] [--seeds N]
+//
+// The latency table in the uart_rx_task commit was made with --seconds 20 --seeds 3.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "crc16.h"
+#include "host_test.h"
+#include "uart_receiver.h"
+
+using namespace esphome;
+using namespace esphome::nspanel_lovelace;
+
+using steady_clock = std::chrono::steady_clock;
+
+static uint64_t now_us() {
+  static const auto start = steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(steady_clock::now() - start).count();
+}
+
+// The display end of the UART, with a receive buffer as large as ESPHome's default
+class FakeUart : public uart::UARTComponent {
+public:
+  static constexpr size_t RX_BUFFER_SIZE = 256;
+
+  int available() override {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    if (this->paused_reader_) this->reads_while_paused_++;
+    return this->rx_.size();
+  }
+  bool read_array(uint8_t *data, size_t len) override {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    if (this->paused_reader_) this->reads_while_paused_++;
+    if (this->rx_.size() < len) return false;
+    std::copy_n(this->rx_.begin(), len, data);
+    this->rx_.erase(this->rx_.begin(), this->rx_.begin() + len);
+    return true;
+  }
+  void send(const std::vector<uint8_t> &data) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    for (auto byte : data) {
+      if (this->rx_.size() < RX_BUFFER_SIZE) {
+        this->rx_.push_back(byte);
+      } else {
+        this->overflow_bytes_++;
+      }
+    }
+  }
+  // reads are counted as errors while the receiver should be paused
+  void set_paused_reader(bool paused) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->paused_reader_ = paused;
+  }
+  uint32_t get_reads_while_paused() const { return this->reads_while_paused_; }
+  uint32_t get_overflow_bytes() const { return this->overflow_bytes_; }
+
+protected:
+  std::mutex mutex_;
+  std::deque<uint8_t> rx_;
+  bool paused_reader_ = false;
+  std::atomic<uint32_t> reads_while_paused_{0};
+  std::atomic<uint32_t> overflow_bytes_{0};
+};
+
+static std::vector<uint8_t> make_frame(const std::string &payload) {
+  std::vector<uint8_t> frame(4 + payload.size());
+  frame[0] = 0x55;
+  frame[1] = 0xBB;
+  frame[2] = payload.size() & 0xFF;
+  frame[3] = payload.size() >> 8;
+  std::copy(payload.begin(), payload.end(), frame.begin() + 4);
+  const uint16_t crc = Crc16::calculate(frame.data(), frame.size());
+  frame.push_back(crc & 0xFF);
+  frame.push_back(crc >> 8);
+  return frame;
+}
+
+static bool pop_message(UartReceiver &receiver, uart_rx_message &message) {
+  const uint64_t timeout = now_us() + 1000000;
+  while (now_us() < timeout) {
+    if (receiver.pop(message)) return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+// Sends the data in small pieces like the UART does
+static void send_in_pieces(FakeUart &uart, const std::vector<uint8_t> &data) {
+  for (size_t i = 0; i < data.size(); i += 7) {
+    uart.send(std::vector<uint8_t>(data.begin() + i, data.begin() + std::min(data.size(), i + 7)));
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+}
+
+static void test_messages() {
+  FakeUart uart;
+  UartReceiver receiver;
+  CHECK(receiver.start(&uart));
+
+  auto frame = make_frame("event,buttonPress2,light.kitchen,OnOff,1");
+  auto corrupt = make_frame("event,startup,53,eu");
+  corrupt[6] ^= 0xFF;
+  std::vector<uint8_t> data = {0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
+  data.insert(data.end(), corrupt.begin(), corrupt.end());
+  data.insert(data.end(), frame.begin(), frame.end());
+  send_in_pieces(uart, data);
+
+  uart_rx_message message;
+  CHECK(pop_message(receiver, message));
+  CHECK(message.result == frame_result::nextion_startup);
+  bool found_frame = false, found_invalid = false;
+  while (pop_message(receiver, message)) {
+    if (message.result == frame_result::invalid) found_invalid = true;
+    if (message.result == frame_result::frame) {
+      found_frame = true;
+      CHECK_EQ(std::string(reinterpret_cast<const char *>(message.data.data()), message.length),
+        "event,buttonPress2,light.kitchen,OnOff,1");
+      break;
+    }
+  }
+  CHECK(found_invalid);
+  CHECK(found_frame);
+
+  // the largest frame the parser accepts fits in a message
+  const std::string largest(FRAME_MAX_PAYLOAD_SIZE, 'x');
+  send_in_pieces(uart, make_frame(largest));
+  CHECK(pop_message(receiver, message));
+  CHECK(message.result == frame_result::frame);
+  CHECK_EQ(std::string(reinterpret_cast<const char *>(message.data.data()), message.length), largest);
+  CHECK_EQ(receiver.get_dropped_count(), 0u);
+  CHECK_EQ(receiver.get_stats().received, 4u);
+
+  // messages which don't fit in the queue are dropped and counted
+  for (size_t i = 0; i < UART_RX_TASK_QUEUE_SIZE + 3; i++) send_in_pieces(uart, frame);
+  // let the task read the last frame
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  size_t received = 0;
+  while (receiver.pop(message)) received++;
+  CHECK_EQ(received, UART_RX_TASK_QUEUE_SIZE);
+  CHECK_EQ(receiver.get_dropped_count(), 3u);
+  receiver.stop();
+}
+
+// pause() must only return once the task has stopped reading, also right after resume()
+static void test_pause() {
+  FakeUart uart;
+  UartReceiver receiver;
+  CHECK(receiver.start(&uart));
+  const auto frame = make_frame("event,sleepReached,cardEntities");
+  for (int i = 0; i < 300; i++) {
+    uart.send(frame);
+    receiver.pause();
+    uart.set_paused_reader(true);
+    for (int spin = 0; spin < (i % 5) * 50; spin++) std::this_thread::yield();
+    uart.set_paused_reader(false);
+    receiver.resume();
+    if (i % 3 != 0) std::this_thread::yield();
+  }
+  receiver.stop();
+  std::printf("pause/resume: reads while paused=%u\n", uart.get_reads_while_paused());
+  CHECK_EQ(uart.get_reads_while_paused(), 0u);
+}
+
+struct latency_result {
+  size_t presses = 0;
+  // 0.1ms units
+  std::vector<uint32_t> latencies;
+};
+
+// The display sends single presses (on average every 200ms) and slider drags
+// (8 frames, one every 20ms). loop() runs every 16ms and 8% of the time it is
+// blocked for 30-150ms (API, WiFi, page renders).
+static latency_result simulate(bool task_mode, unsigned seed, int seconds) {
+  FakeUart uart;
+  latency_result result;
+  std::vector<uint64_t> pressed_at(1u << 16, 0);
+  std::atomic<bool> done{false};
+  std::atomic<size_t> presses{0};
+
+  std::thread display([&]() {
+    std::mt19937 rng(seed);
+    std::exponential_distribution<double> gap_ms(1.0 / 200);
+    std::uniform_int_distribution<int> percent(0, 99);
+    const uint64_t end = now_us() + seconds * 1000000ull;
+    size_t id = 0;
+    while (now_us() < end && id + 8 < pressed_at.size()) {
+      const int frames = percent(rng) < 15 ? 8 : 1;
+      for (int i = 0; i < frames; i++) {
+        char payload[96];
+        std::snprintf(payload, sizeof(payload), "event,buttonPress2,light.living_room_lamp,%s,%zu",
+          frames > 1 ? "brightnessSlider" : "button", id);
+        auto frame = make_frame(payload);
+        // ~87us per byte at 115200 baud
+        std::this_thread::sleep_for(std::chrono::microseconds(87 * frame.size()));
+        pressed_at[id++] = now_us();
+        uart.send(frame);
+        if (frames > 1) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int>(gap_ms(rng) * 1000)));
+    }
+    presses = id;
+    done = true;
+  });
+
+  auto dispatch = [&](const uint8_t *data, size_t len) {
+    std::string payload(reinterpret_cast<const char *>(data), len);
+    const size_t id = std::strtoul(payload.c_str() + payload.rfind(',') + 1, nullptr, 10);
+    result.latencies.push_back((now_us() - pressed_at[id]) / 100);
+  };
+
+  FrameParser parser;
+  UartReceiver receiver;
+  if (task_mode) receiver.start(&uart);
+  static uart_rx_message message;
+  std::mt19937 rng(seed + 1);
+  std::uniform_int_distribution<int> percent(0, 99), blocked_ms(30, 150);
+  while (!done) {
+    if (task_mode) {
+      while (receiver.pop(message)) {
+        if (message.result == frame_result::frame) dispatch(message.data.data(), message.length);
+      }
+    } else {
+      // the same as NSPanelLovelace::loop() without the task
+      auto &buffer = parser.get_buffer();
+      int available;
+      while ((available = uart.available()) > 0) {
+        size_t len;
+        uint8_t *data = buffer.write_region(len);
+        if (len == 0) break;
+        len = std::min(len, static_cast<size_t>(available));
+        if (!uart.read_array(data, len)) break;
+        buffer.commit(len);
+        frame_result frame;
+        while ((frame = parser.parse()) != frame_result::incomplete) {
+          if (frame == frame_result::frame) dispatch(parser.get_payload(), parser.get_payload_length());
+        }
+      }
+    }
+    const int work_ms = percent(rng) < 8 ? blocked_ms(rng) : 2;
+    std::this_thread::sleep_for(std::chrono::milliseconds(16 + work_ms));
+  }
+  display.join();
+  receiver.stop();
+  result.presses = presses;
+  return result;
+}
+
+static void report(const char *mode, latency_result &result) {
+  auto &latencies = result.latencies;
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double p) {
+    if (latencies.empty()) return 0.0;
+    return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))] / 10.0;
+  };
+  std::printf("  %-4s %7zu %5zu %6.1fms %6.1fms %7.1fms %7.1fms\n", mode,
+    result.presses, result.presses - latencies.size(),
+    percentile(0.5), percentile(0.9), percentile(0.99), latencies.empty() ? 0.0 : latencies.back() / 10.0);
+}
+
+int main(int argc, char **argv) {
+  int seconds = 2, seeds = 1;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--seconds") == 0) seconds = std::atoi(argv[i + 1]);
+    if (std::strcmp(argv[i], "--seeds") == 0) seeds = std::atoi(argv[i + 1]);
+  }
+
+  test_messages();
+  test_pause();
+
+  latency_result off, on;
+  for (int seed = 1; seed <= seeds; seed++) {
+    for (bool task_mode : {false, true}) {
+      auto result = simulate(task_mode, seed, seconds);
+      auto &total = task_mode ? on : off;
+      total.presses += result.presses;
+      total.latencies.insert(total.latencies.end(), result.latencies.begin(), result.latencies.end());
+    }
+  }
+  std::printf("button press to dispatch (%d x %ds):\n", seeds, seconds);
+  std::printf("       presses  lost     p50      p90      p99      max\n");
+  report("off", off);
+  report("on", on);
+
+  return host_test_failures;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+// Runs jobs and list attribute updates through the worker task.
+// Build with -DNSPANEL_TESTS_TSAN=ON to check the hand over between the tasks.
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "entity.h"
+#include "host_test.h"
+#include "worker.h"
+
+using namespace esphome::nspanel_lovelace;
+
+static void wait_for(Worker &worker) {
+  while (worker.is_busy()) {
+    worker.loop();
+    std::this_thread::yield();
+  }
+}
+
+// Submits the update the way NSPanelLovelace::on_entity_update_() does
+static void submit_list_update(Worker &worker, Entity &entity, ha_attr_type attr, std::string value) {
+  if (!entity.record_list_update(attr, value)) return;
+  worker.submit(make_worker_job(std::make_pair(std::move(value), Entity::parsed_list{}),
+    [attr](std::pair<std::string, Entity::parsed_list> &update) {
+      update.second = Entity::parse_list_attribute(attr, std::move(update.first));
+    },
+    [&entity, attr](std::pair<std::string, Entity::parsed_list> &update) {
+      entity.set_attribute(attr, std::move(update.second));
+    }));
+}
+
+static bool same_list(const Entity &a, const Entity &b, ha_attr_type attr) {
+  auto list_a = a.get_attribute_list(attr), list_b = b.get_attribute_list(attr);
+  if (list_a.size() != list_b.size()) return false;
+  for (size_t i = 0; i < list_a.size(); i++) {
+    if (list_a[i] != list_b[i]) return false;
+  }
+  return true;
+}
+
+int main() {
+  Worker worker;
+  CHECK(worker.start());
+
+  // jobs run on the worker and are completed in loop() in the order they were submitted
+  struct job_state {
+    int number;
+    std::thread::id ran_on;
+  };
+  const auto main_thread = std::this_thread::get_id();
+  const int job_count = 20000;
+  int next = 0, out_of_order = 0, on_main_thread = 0;
+  for (int i = 0; i < job_count; i++) {
+    worker.submit(make_worker_job(job_state{i, {}},
+      [](job_state &state) { state.ran_on = std::this_thread::get_id(); },
+      [&](job_state &state) {
+        if (state.number != next++) out_of_order++;
+        if (state.ran_on == main_thread) on_main_thread++;
+      }));
+    if (i % 7 == 0) worker.loop();
+  }
+  wait_for(worker);
+  std::printf("jobs: completed=%u max_pending=%zu\n", worker.get_completed_count(), worker.get_max_pending());
+  CHECK_EQ(next, job_count);
+  CHECK_EQ(out_of_order, 0);
+  CHECK_EQ(on_main_thread, 0);
+
+  // list updates through the worker end up the same as when they are set inline
+  const char *updates[] = {
+    "['a', 'b, c']", "['a', 'b, c']", "None", "['x']", "['y', 'z']", "None", "None", "['q, r']"};
+  Entity through_worker("select.worker"), set_inline("select.inline");
+  for (auto value : updates) {
+    submit_list_update(worker, through_worker, ha_attr_type::options, value);
+    set_inline.set_attribute(ha_attr_type::options, value);
+  }
+  wait_for(worker);
+  CHECK(same_list(through_worker, set_inline, ha_attr_type::options));
+  CHECK_EQ(std::string(through_worker.get_attribute_list(ha_attr_type::options)[0]), "q, r");
+
+  // a reconnect sends the same lists again, they are dropped before being submitted
+  const char *sync[] = {"['off', 'heat', 'cool']", "['home', 'away']", "['auto', 'on']"};
+  const ha_attr_type attrs[] = {ha_attr_type::hvac_modes, ha_attr_type::preset_modes, ha_attr_type::fan_modes};
+  Entity climate("climate.ecobee");
+  for (int i = 0; i < 3; i++) submit_list_update(worker, climate, attrs[i], sync[i]);
+  wait_for(worker);
+  const uint32_t submitted = worker.get_completed_count();
+  for (int reconnect = 0; reconnect < 3; reconnect++) {
+    for (int i = 0; i < 3; i++) submit_list_update(worker, climate, attrs[i], sync[i]);
+  }
+  // a value which is still waiting for the worker counts as the last one
+  submit_list_update(worker, climate, ha_attr_type::fan_modes, "['low']");
+  submit_list_update(worker, climate, ha_attr_type::fan_modes, "['low']");
+  wait_for(worker);
+  std::printf("reconnect: list jobs submitted=%u\n", worker.get_completed_count() - submitted);
+  CHECK_EQ(worker.get_completed_count() - submitted, 1u);
+  CHECK_EQ(std::string(climate.get_attribute_list(ha_attr_type::fan_modes)[0]), "low");
+
+  worker.stop();
+  // jobs are run and completed straight away when the worker isn't running
+  int completed_inline = 0;
+  worker.submit(make_worker_job(0, [](int &) {}, [&](int &) { completed_inline++; }));
+  CHECK_EQ(completed_inline, 1);
+
+  return host_test_failures;
+}
\ No newline at end of file
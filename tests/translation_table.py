@@ -0,0 +1,101 @@
+"""Generates the translation table for a translation file the same way the
+component does, as a header for test_translations.cpp.
+
+    python3 translation_table.py <translation.json> <output.h>
+
+The component's __init__.py is loaded with the esphome modules replaced by
+mocks, only build_translation_table() and the key lists are used.
+"""
+import importlib.util
+import json
+import os
+import sys
+from unittest import mock
+
+COMPONENT_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "components", "nspanel_lovelace")
+
+ESPHOME_MODULES = [
+    "esphome", "esphome.automation", "esphome.config_validation", "esphome.config_helpers",
+    "esphome.codegen", "esphome.core", "esphome.components", "esphome.components.uart",
+    "esphome.components.time", "esphome.components.esp32", "esphome.const",
+]
+
+
+def load_component():
+    for name in ESPHOME_MODULES:
+        sys.modules[name] = mock.MagicMock()
+        # "import esphome.x as y" takes the attribute of the parent module
+        parent, _, child = name.rpartition(".")
+        if parent:
+            setattr(sys.modules[parent], child, sys.modules[name])
+    # the translation keys translation_item renames (see esphome.config_validation.RESERVED_IDS)
+    sys.modules["esphome.config_validation"].RESERVED_IDS = {"auto", "sleep", "pause"}
+    # raised by build_translation_table()
+    sys.modules["esphome.config_validation"].Invalid = ValueError
+    spec = importlib.util.spec_from_file_location("nspanel_lovelace", os.path.join(COMPONENT_DIR, "__init__.py"))
+    component = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(component)
+    return component
+
+
+def cpp_string(value: str) -> str:
+    out = '"'
+    for b in value.encode("utf-8"):
+        c = chr(b)
+        if c in '"\\':
+            out += "\\" + c
+        elif 0x20 <= b < 0x7F:
+            out += c
+        else:
+            out += f"\\{b:03o}"
+    return out + '"'
+
+
+def main(json_path: str, header_path: str):
+    component = load_component()
+    with open(json_path, encoding="utf-8") as f:
+        translations = json.load(f)
+
+    # the same steps as to_code() in __init__.py
+    lookup_keys = [component.TRANSLATION_KEY_ALIASES.get(k, k) for k in translations.keys()]
+    slots, seeds = component.build_translation_table(lookup_keys)
+    json_keys = dict(zip(lookup_keys, translations.keys()))
+
+    lines = [
+        f"// Generated by translation_table.py from {os.path.basename(json_path)}",
+        "#pragma once",
+        f"#define TRANSLATION_MAP_SIZE {len(slots)}",
+        '#include "translations.h"',
+        "",
+        "constexpr esphome::nspanel_lovelace::translation_table_t esphome::nspanel_lovelace::TRANSLATION_MAP {{",
+    ]
+    lines += [f"  {{{cpp_string(k)}, {cpp_string(translations[json_keys[k]])}}}," for k in slots]
+    lines += [
+        "}};",
+        "constexpr esphome::nspanel_lovelace::translation_seeds_t esphome::nspanel_lovelace::TRANSLATION_SEEDS {{",
+        "  " + ", ".join(str(s) for s in seeds),
+        "}};",
+        "",
+        "// every key in the file, as it is looked up, with its value",
+        "static const std::pair<const char *, const char *> TRANSLATION_FILE_ENTRIES[] = {",
+    ]
+    lines += [f"  {{{cpp_string(k)}, {cpp_string(translations[json_keys[k]])}}}," for k in lookup_keys]
+    lines += [
+        "};",
+        "",
+        "// the translation_item used by the C++ code for each required key, with its value",
+        "static const std::pair<const char *, const char *> TRANSLATION_ITEM_ENTRIES[] = {",
+    ]
+    for k in component.REQUIRED_TRANSLATION_KEYS:
+        item = k + "_" if k in component.cv.RESERVED_IDS else k
+        lines.append(f"  {{esphome::nspanel_lovelace::translation_item::{item}, {cpp_string(translations[k])}}},")
+    lines.append("};")
+
+    with open(header_path, "w", encoding="utf-8") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    main(sys.argv[1], sys.argv[2])